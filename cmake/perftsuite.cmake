@@ -0,0 +1,43 @@
+#Checks the move generator against the well known perft counts
+#cmake -DENGINE=<path to jing-wei> -P perftsuite.cmake
+
+if(NOT ENGINE)
+    message(FATAL_ERROR "Usage: cmake -DENGINE=<path to jing-wei> -P perftsuite.cmake")
+endif()
+
+#Each entry is fen|depth|node count
+set(PERFT_POSITIONS
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1|5|4865609"
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1|4|4085603"
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1|5|674624"
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1|4|422333"
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8|4|2103487"
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10|4|3894594")
+
+set(PERFT_FAILURES 0)
+
+foreach(PERFT_POSITION ${PERFT_POSITIONS})
+    string(REPLACE "|" ";" PERFT_FIELDS "${PERFT_POSITION}")
+    list(GET PERFT_FIELDS 0 PERFT_FEN)
+    list(GET PERFT_FIELDS 1 PERFT_DEPTH)
+    list(GET PERFT_FIELDS 2 PERFT_EXPECTED)
+
+    execute_process(
+        COMMAND ${ENGINE} "setboard ${PERFT_FEN}" "perft ${PERFT_DEPTH}" quit
+        OUTPUT_VARIABLE PERFT_OUTPUT
+        RESULT_VARIABLE PERFT_RESULT)
+
+    string(REGEX MATCH "Total: ([0-9]+) Moves" PERFT_MATCH "${PERFT_OUTPUT}")
+    set(PERFT_ACTUAL "${CMAKE_MATCH_1}")
+
+    if(NOT PERFT_RESULT EQUAL 0 OR NOT PERFT_ACTUAL STREQUAL PERFT_EXPECTED)
+        message(STATUS "FAIL ${PERFT_FEN} depth ${PERFT_DEPTH}: expected ${PERFT_EXPECTED}, got '${PERFT_ACTUAL}'")
+        math(EXPR PERFT_FAILURES "${PERFT_FAILURES} + 1")
+    else()
+        message(STATUS "ok   ${PERFT_FEN} depth ${PERFT_DEPTH}: ${PERFT_ACTUAL}")
+    endif()
+endforeach()
+
+if(PERFT_FAILURES GREATER 0)
+    message(FATAL_ERROR "${PERFT_FAILURES} perft positions failed")
+endif()
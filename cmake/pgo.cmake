@@ -0,0 +1,78 @@
+#Builds a variant instrumented, trains it on jing-wei-bench, then rebuilds it with the profile
+#Run by the pgo and pgo-variants targets, which pass the variables below
+
+foreach(PGO_VARIABLE SOURCE_DIR BINARY_DIR OUTPUT_DIR GENERATOR CXX_COMPILER CXX_COMPILER_ID ARCH)
+    if(NOT DEFINED ${PGO_VARIABLE})
+        message(FATAL_ERROR "pgo.cmake needs -D${PGO_VARIABLE}")
+    endif()
+endforeach()
+
+if(ARCH STREQUAL "native")
+    set(PGO_SUFFIX "")
+else()
+    set(PGO_SUFFIX "-${ARCH}")
+endif()
+
+set(PGO_PROFILE_DIR ${BINARY_DIR}/pgo-profile)
+
+function(pgo_build PGO_PHASE)
+    execute_process(
+        COMMAND ${CMAKE_COMMAND} -S ${SOURCE_DIR} -B ${BINARY_DIR} -G ${GENERATOR}
+            -DCMAKE_BUILD_TYPE=Release -DCMAKE_CXX_COMPILER=${CXX_COMPILER}
+            -DJINGWEI_ARCH=${ARCH} -DJINGWEI_PGO=${PGO_PHASE} -DJINGWEI_PGO_DIR=${PGO_PROFILE_DIR}
+        RESULT_VARIABLE PGO_RESULT)
+
+    if(NOT PGO_RESULT EQUAL 0)
+        message(FATAL_ERROR "Configuring ${ARCH} with JINGWEI_PGO=${PGO_PHASE} failed")
+    endif()
+
+    execute_process(
+        COMMAND ${CMAKE_COMMAND} --build ${BINARY_DIR} --target jing-wei jing-wei-bench --parallel
+        RESULT_VARIABLE PGO_RESULT)
+
+    if(NOT PGO_RESULT EQUAL 0)
+        message(FATAL_ERROR "Building ${ARCH} with JINGWEI_PGO=${PGO_PHASE} failed")
+    endif()
+endfunction()
+
+#1) Instrumented build, starting from an empty profile
+file(REMOVE_RECURSE ${PGO_PROFILE_DIR})
+
+pgo_build(GENERATE)
+
+#2) Training run, which can't happen when the host lacks the variant's instruction set
+separate_arguments(PGO_BENCH_ARGS UNIX_COMMAND "${BENCH_ARGS}")
+
+message(STATUS "Training jing-wei${PGO_SUFFIX} on jing-wei-bench ${BENCH_ARGS}")
+
+execute_process(
+    COMMAND ${BINARY_DIR}/bin/jing-wei-bench${PGO_SUFFIX} ${PGO_BENCH_ARGS}
+    RESULT_VARIABLE PGO_RESULT)
+
+set(PGO_PHASE USE)
+
+if(NOT PGO_RESULT EQUAL 0)
+    message(WARNING "Training jing-wei${PGO_SUFFIX} failed (${PGO_RESULT}), building it without a profile")
+    set(PGO_PHASE OFF)
+elseif(CXX_COMPILER_ID MATCHES "Clang")
+    #Clang writes raw profiles that have to be merged before they can be used
+    get_filename_component(PGO_COMPILER_DIR ${CXX_COMPILER} DIRECTORY)
+    find_program(PGO_LLVM_PROFDATA NAMES llvm-profdata HINTS ${PGO_COMPILER_DIR})
+
+    file(GLOB PGO_RAW_PROFILES ${PGO_PROFILE_DIR}/*.profraw)
+
+    if(NOT PGO_LLVM_PROFDATA OR NOT PGO_RAW_PROFILES)
+        message(WARNING "Unable to merge the Clang profile, building jing-wei${PGO_SUFFIX} without it")
+        set(PGO_PHASE OFF)
+    else()
+        execute_process(COMMAND ${PGO_LLVM_PROFDATA} merge -output=${PGO_PROFILE_DIR}/default.profdata ${PGO_RAW_PROFILES})
+    endif()
+endif()
+
+#3) Optimized build, in the same tree so the profile matches the object files
+pgo_build(${PGO_PHASE})
+
+file(MAKE_DIRECTORY ${OUTPUT_DIR})
+file(COPY ${BINARY_DIR}/bin/jing-wei${PGO_SUFFIX} ${BINARY_DIR}/bin/jing-wei-bench${PGO_SUFFIX} DESTINATION ${OUTPUT_DIR})
+
+message(STATUS "Built ${OUTPUT_DIR}/jing-wei${PGO_SUFFIX} with JINGWEI_PGO=${PGO_PHASE}")
@@ -0,0 +1,105 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <cstdlib>
+
+#include "../src/chess/bench/microbench.h"
+#include "../src/chess/bitboards/magics.h"
+
+#include "../src/chess/search/searcher.h"
+#include "../src/chess/search/statistics.h"
+
+#include "../src/game/clock/profiler.h"
+#include "../src/game/math/cpufeatures.h"
+
+//Searches each starting position of the corpus to this depth, for the node count and the search counters
+constexpr Depth BenchmarkSearchDepth = Depth::TEN;
+
+static void runSearchBenchmark(const std::vector<std::string>& fens)
+{
+    ChessSearcher searcher;
+
+    Clock clock;
+    clock.setClockDepth(BenchmarkSearchDepth);
+
+    NodeCount nodeCount = ZeroNodes;
+    std::time_t searchTime = 0;
+
+    for (const std::string& fen : fens) {
+        ChessBoard board;
+        board.initFromFen(fen);
+
+        ChessPrincipalVariation principalVariation;
+
+        searcher.resetHashtable();
+        searcher.resetMoveHistory();
+        searcher.setClock(clock);
+        searcher.iterativeDeepeningLoop(board, principalVariation);
+
+        nodeCount += searcher.getNodeCount();
+        searchTime += searcher.getSearchTime();
+    }
+
+    std::cout << "Search: " << fens.size() << " positions to depth " << int(BenchmarkSearchDepth) << ", " << nodeCount << " nodes, "
+        << nodeCount * 1000 / std::max(searchTime, std::time_t(1)) << " nps" << std::endl;
+
+    if (enableSearchStatistics) {
+        GetSearchStatistics().print();
+    }
+
+    if (enableCycleProfiler) {
+        GetCycleProfile().print();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    //jing-wei-bench [epd file, or - for the built in positions] [samples]
+    ChessMicroBenchmark microBenchmark(argc > 2 ? std::atoi(argv[2]) : 10);
+
+    if (argc > 1
+        && std::string(argv[1]) != "-") {
+        if (!microBenchmark.loadPositions(argv[1])) {
+            std::cout << "Unable to load positions from " << argv[1] << std::endl;
+            return 1;
+        }
+    }
+    else {
+        microBenchmark.addDefaultPositions();
+    }
+
+    const CpuFeatures& cpuFeatures = GetCpuFeatures();
+
+    std::cout << "Cpu: popcnt " << (cpuFeatures.popcnt ? "yes" : "no") << ", bmi2 " << (cpuFeatures.bmi2 ? "yes" : "no")
+        << ", slider index " << (SliderIndexing == MagicIndexing::PEXT ? "pext" : "multiply") << std::endl;
+
+    std::cout << "Benchmarking over " << microBenchmark.size() << " positions" << std::endl;
+
+    const std::vector<MicroBenchmarkResult> results = microBenchmark.run();
+    ChessMicroBenchmark::print(results);
+
+    std::cout << "Checksum " << std::hex << microBenchmark.getChecksum() << std::dec << std::endl;
+
+    runSearchBenchmark(microBenchmark.getFens());
+
+    return 0;
+}
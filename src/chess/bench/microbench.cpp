@@ -0,0 +1,370 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "microbench.h"
+
+#include "../bitboards/magics.h"
+
+#include "../../game/math/statistics.h"
+
+//Openings, middlegames and endgames, with and without castling rights, en passant and promotions
+static const char* DefaultMicroBenchmarkFens[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 11",
+    "4rrk1/pp1n3p/3q2pQ/2p1pb2/2PP4/2P3N1/P2B2PP/4RRK1 b - - 7 19",
+    "rq3rk1/ppp2ppp/1bnpb3/3N2B1/3NP3/7P/PPPQ1PP1/2KR3R w - - 7 14",
+    "r1bq1r1k/1pp1n1pp/1p1p4/4p2Q/4Pp2/1BNP4/PPP2PPP/3R1RK1 w - - 2 14",
+    "r3r1k1/2p2ppp/p1p1bn2/8/1q2P3/2NPQN2/PPP3PP/R4RK1 b - - 2 15",
+    "r1bbk1nr/pp3p1p/2n5/1N4p1/2Np1B2/8/PPP2PPP/2KR1B1R w kq - 0 13",
+    "r1bq1rk1/ppp1nppp/4n3/3p3Q/3P4/1BP1B3/PP1N2PP/R4RK1 w - - 1 16",
+    "4r1k1/r1q2ppp/ppp2n2/4P3/5Rb1/1N1BQ3/PPP3PP/R5K1 w - - 1 17",
+    "2rqkb1r/ppp2p2/2npb1p1/1N1Nn2p/2P1PP2/8/PP2B1PP/R1BQK2R b KQ - 0 11",
+    "r1bq1r1k/b1p1npp1/p2p3p/1p6/3PP3/1B2NN2/PP3PPP/R2Q1RK1 w - - 1 16",
+    "3r1rk1/p5pp/bpp1pp2/8/q1PP1P2/b3P3/P2NQRPP/1R2B1K1 b - - 6 22",
+    "r1q2rk1/2p1bppp/2Pp4/p6b/Q1PNp3/4B3/PP1R1PPP/2K4R w - - 2 18",
+    "4k2r/1pb2ppp/1p2p3/1R1p4/3P4/2r1PN2/P4PPP/1R4K1 b - - 3 22",
+    "3q2k1/pb3p1p/4pbp1/2r5/PpN2N2/1P2P2P/5PP1/Q2R2K1 b - - 4 26",
+    "rnbqkb1r/pp1p1ppp/4pn2/2pP4/2P5/8/PP2PPPP/RNBQKBNR w KQkq c6 0 4",
+    "6k1/6p1/6Pp/ppp5/3pn2P/1P3K2/1PP2P2/3N4 b - - 0 1",
+    "3b4/5kp1/1p1p1p1p/pP1PpP1P/P1P1P3/3KN3/8/8 w - - 0 1",
+    "2K5/p7/7P/5pR1/8/5k2/r7/8 w - - 0 1",
+    "8/6pk/1p6/8/PP3p1p/5P2/4KP1q/3Q4 w - - 0 1",
+    "7k/3p2pp/4q3/8/4Q3/5Kp1/P6b/8 w - - 0 1",
+    "8/2p5/8/2kPKp1p/2p4P/2P5/3P4/8 w - - 0 1",
+    "8/1p3pp1/7p/5P1P/2k3P1/8/2K2P2/8 w - - 0 1",
+    "8/pp2r1k1/2p1p3/3pP2p/1P1P1P1P/P5KR/8/8 w - - 0 1",
+    "8/3p4/p1bk3p/Pp6/1Kp1PpPp/2P2P1P/2P5/5B2 b - - 0 1",
+    "5k2/7R/4P2p/5K2/p1r2P1p/8/8/8 b - - 0 1",
+    "6k1/6p1/P6p/r1N5/5p2/7P/1b3PP1/4R1K1 w - - 0 1",
+    "1r3k2/4q3/2Pp3b/3Bp3/2Q2p2/1p1P2P1/1P2KP2/3N4 w - - 0 1",
+    "6k1/4pp1p/3p2p1/P1pPb3/R7/1r2P1PP/3B1P2/6K1 w - - 0 1",
+    "8/3p3B/5p2/5P2/p7/PP5b/k7/6K1 w - - 0 1",
+    "8/P1k5/8/8/8/8/5Kp1/8 w - - 0 1"
+};
+
+//Each sample runs the corpus often enough to take about this long, so the clock's resolution doesn't matter
+constexpr std::chrono::nanoseconds MinimumSampleTime = std::chrono::milliseconds(20);
+
+ChessMicroBenchmark::ChessMicroBenchmark(std::uint32_t sampleCount)
+    : sampleCount(sampleCount)
+{
+
+}
+
+void ChessMicroBenchmark::addPosition(const ChessBoard& board)
+{
+    MicroBenchmarkPosition position = {
+        .board = board,
+        .isInCheck = this->attackGenerator.dispatchIsInCheck(board)
+    };
+
+    ChessMoveList moveList;
+
+    this->moveGenerator.DispatchGenerateAllMoves(board, moveList);
+    position.moves.assign(moveList.begin(), moveList.end());
+
+    this->moveGenerator.DispatchGenerateAllCaptures(board, moveList);
+    position.captures.assign(moveList.begin(), moveList.end());
+
+    this->positions.push_back(position);
+}
+
+void ChessMicroBenchmark::addFen(const std::string& fen)
+{
+    ChessBoard board;
+    board.initFromFen(fen);
+
+    this->fens.push_back(fen);
+    this->addPosition(board);
+
+    const std::vector<ChessMove> moves = this->positions.back().moves;
+
+    for (ChessMove move : moves) {
+        ChessBoard nextBoard = board;
+        this->boardMover.dispatchDoMove(nextBoard, move);
+
+        this->addPosition(nextBoard);
+    }
+}
+
+void ChessMicroBenchmark::addDefaultPositions()
+{
+    for (const char* fen : DefaultMicroBenchmarkFens) {
+        this->addFen(fen);
+    }
+}
+
+std::uint64_t ChessMicroBenchmark::getChecksum() const
+{
+    return this->checksum;
+}
+
+const std::vector<std::string>& ChessMicroBenchmark::getFens() const
+{
+    return this->fens;
+}
+
+bool ChessMicroBenchmark::loadPositions(const std::string& fileName)
+{
+    std::ifstream inputFile(fileName);
+
+    if (!inputFile.is_open()) {
+        return false;
+    }
+
+    //EPD lines carry four FEN fields, FEN lines six; either way the counters aren't needed
+    std::string line;
+    while (std::getline(inputFile, line)) {
+        std::stringstream ss(line);
+        std::string fields[4];
+
+        if (!(ss >> fields[0] >> fields[1] >> fields[2] >> fields[3])) {
+            continue;
+        }
+
+        this->addFen(fields[0] + ' ' + fields[1] + ' ' + fields[2] + ' ' + fields[3] + " 0 1");
+    }
+
+    return true;
+}
+
+template <class Operation>
+MicroBenchmarkResult ChessMicroBenchmark::measure(const std::string& name, Operation operation)
+{
+    using Clock = std::chrono::steady_clock;
+
+    //1) One pass to warm the caches and see how many passes fill a sample
+    Clock::time_point start = Clock::now();
+    const NodeCount operationCount = operation();
+    const Clock::duration passTime = Clock::now() - start;
+
+    const std::uint64_t passes = std::max<std::uint64_t>(1, MinimumSampleTime / std::max(passTime, Clock::duration(1)));
+
+    //2) Time each sample
+    Statistics<double> statistics;
+    double minimumNanoseconds = 0.0;
+
+    for (std::uint32_t sample = 0; sample < this->sampleCount; sample++) {
+        start = Clock::now();
+
+        for (std::uint64_t pass = 0; pass < passes; pass++) {
+            operation();
+        }
+
+        const double nanoseconds = double(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        const double nanosecondsPerOperation = nanoseconds / double(passes * std::max(operationCount, OneNode));
+
+        statistics.push_back(nanosecondsPerOperation);
+        minimumNanoseconds = sample == 0 ? nanosecondsPerOperation : std::min(minimumNanoseconds, nanosecondsPerOperation);
+    }
+
+    return {
+        .name = name,
+        .operationCount = operationCount,
+        .averageNanoseconds = statistics.average(),
+        .stddevNanoseconds = statistics.stddev(),
+        .minimumNanoseconds = minimumNanoseconds
+    };
+}
+
+void ChessMicroBenchmark::print(const std::vector<MicroBenchmarkResult>& results)
+{
+    std::cout << std::left << std::setw(22) << "primitive" << std::right
+        << std::setw(12) << "ops/pass" << std::setw(12) << "ns/op" << std::setw(12) << "stddev" << std::setw(10) << "rsd %" << std::setw(12) << "min ns/op" << std::endl;
+
+    for (const MicroBenchmarkResult& result : results) {
+        const double relativeStddev = result.averageNanoseconds == 0.0 ? 0.0 : 100.0 * result.stddevNanoseconds / result.averageNanoseconds;
+
+        std::cout << std::left << std::setw(22) << result.name << std::right << std::fixed
+            << std::setw(12) << result.operationCount
+            << std::setprecision(2) << std::setw(12) << result.averageNanoseconds << std::setw(12) << result.stddevNanoseconds
+            << std::setw(10) << relativeStddev << std::setw(12) << result.minimumNanoseconds << std::endl;
+    }
+}
+
+std::vector<MicroBenchmarkResult> ChessMicroBenchmark::run()
+{
+    std::vector<MicroBenchmarkResult> results;
+
+    //1) Slider lookups from every square, with the position's occupancy
+    results.push_back(this->measure("BishopMagic", [this]() {
+        Bitboard result = EmptyBitboard;
+
+        for (const MicroBenchmarkPosition& position : this->positions) {
+            for (const Square src : SquareIterator()) {
+                result ^= BishopMagic(src, position.board.allPieces);
+            }
+        }
+
+        this->checksum += result;
+
+        return NodeCount(this->positions.size() * Square::SQUARE_COUNT);
+    }));
+
+    results.push_back(this->measure("RookMagic", [this]() {
+        Bitboard result = EmptyBitboard;
+
+        for (const MicroBenchmarkPosition& position : this->positions) {
+            for (const Square src : SquareIterator()) {
+                result ^= RookMagic(src, position.board.allPieces);
+            }
+        }
+
+        this->checksum += result;
+
+        return NodeCount(this->positions.size() * Square::SQUARE_COUNT);
+    }));
+
+    //2) Board primitives
+    results.push_back(this->measure("buildAttackBoards", [this]() {
+        Bitboard result = EmptyBitboard;
+
+        for (const MicroBenchmarkPosition& position : this->positions) {
+            AttackBoards attackBoards;
+
+            if (position.board.isWhiteToMove()) {
+                this->attackGenerator.buildAttackBoards<true>(position.board, attackBoards);
+            }
+            else {
+                this->attackGenerator.buildAttackBoards<false>(position.board, attackBoards);
+            }
+
+            result ^= attackBoards.pinnedPieces ^ attackBoards.checkingPieces;
+        }
+
+        this->checksum += result;
+
+        return NodeCount(this->positions.size());
+    }));
+
+    results.push_back(this->measure("calculateHash", [this]() {
+        Hash result = EmptyHash;
+
+        for (const MicroBenchmarkPosition& position : this->positions) {
+            result ^= position.board.calculateHash();
+        }
+
+        this->checksum += result;
+
+        return NodeCount(this->positions.size());
+    }));
+
+    results.push_back(this->measure("generateAllMoves", [this]() {
+        NodeCount result = ZeroNodes;
+        ChessMoveList moveList;
+
+        for (const MicroBenchmarkPosition& position : this->positions) {
+            result += this->moveGenerator.DispatchGenerateAllMoves(position.board, moveList);
+        }
+
+        this->checksum += result;
+
+        return NodeCount(this->positions.size());
+    }));
+
+    results.push_back(this->measure("doMove", [this]() {
+        NodeCount operationCount = ZeroNodes;
+        Hash result = EmptyHash;
+
+        for (const MicroBenchmarkPosition& position : this->positions) {
+            for (ChessMove move : position.moves) {
+                ChessBoard nextBoard = position.board;
+                this->boardMover.dispatchDoMove(nextBoard, move);
+
+                result ^= nextBoard.hashValue;
+            }
+
+            operationCount += position.moves.size();
+        }
+
+        this->checksum += result;
+
+        return operationCount;
+    }));
+
+    results.push_back(this->measure("staticExchange", [this]() {
+        NodeCount operationCount = ZeroNodes;
+        Score result = ZERO_SCORE;
+
+        for (const MicroBenchmarkPosition& position : this->positions) {
+            for (const ChessMove& move : position.captures) {
+                result += this->staticExchangeEvaluator.staticExchangeEvaluation(position.board, move.src, move.dst);
+            }
+
+            operationCount += position.captures.size();
+        }
+
+        this->checksum += result;
+
+        return operationCount;
+    }));
+
+    //3) The evaluation, which expects the side to move not to be in check
+    results.push_back(this->measure("evaluate", [this]() {
+        NodeCount operationCount = ZeroNodes;
+        Score result = ZERO_SCORE;
+
+        for (const MicroBenchmarkPosition& position : this->positions) {
+            if (position.isInCheck) {
+                continue;
+            }
+
+            result += this->evaluator.evaluate(position.board, Depth::ZERO, -INFINITE_SCORE, INFINITE_SCORE);
+            operationCount++;
+        }
+
+        this->checksum += result;
+
+        return operationCount;
+    }));
+
+    //4) Repetition checks against a game's worth of history, half of them for positions that are in it
+    this->moveHistory.clear();
+
+    const std::size_t historySize = std::min<std::size_t>(this->positions.size(), 100);
+
+    for (std::size_t i = 0; i < historySize; i++) {
+        this->moveHistory.push_back(this->positions[i].board, NullMove);
+    }
+
+    results.push_back(this->measure("checkForDuplicateHash", [this, historySize]() {
+        std::uint32_t result = 0;
+
+        for (std::size_t i = 0; i < historySize * 2 && i < this->positions.size(); i++) {
+            result += this->moveHistory.checkForDuplicateHash(this->positions[i].board.hashValue);
+        }
+
+        this->checksum += result;
+
+        return NodeCount(std::min(historySize * 2, this->positions.size()));
+    }));
+
+    return results;
+}
+
+std::size_t ChessMicroBenchmark::size() const
+{
+    return this->positions.size();
+}
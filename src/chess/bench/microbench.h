@@ -0,0 +1,97 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../board/attackgenerator.h"
+#include "../board/board.h"
+#include "../board/boardmover.h"
+#include "../board/movegenerator.h"
+#include "../board/see.h"
+
+#include "../eval/evaluator.h"
+
+#include "../search/movehistory.h"
+
+#include "../../game/types/nodecount.h"
+
+struct MicroBenchmarkPosition
+{
+    ChessBoard board;
+
+    std::vector<ChessMove> moves;
+    std::vector<ChessMove> captures;
+
+    bool isInCheck;
+};
+
+struct MicroBenchmarkResult
+{
+    std::string name;
+
+    NodeCount operationCount;
+
+    double averageNanoseconds;
+    double stddevNanoseconds;
+    double minimumNanoseconds;
+};
+
+//Times the primitives the search is built from, each over the same corpus of positions, so a change to the bitboards
+//or the board code can be judged on its own before it's played out in a match
+class ChessMicroBenchmark
+{
+protected:
+    std::vector<std::string> fens;
+    std::vector<MicroBenchmarkPosition> positions;
+    std::uint32_t sampleCount;
+
+    ChessAttackGenerator attackGenerator;
+    ChessBoardMover boardMover;
+    ChessEvaluator evaluator;
+    ChessMoveGenerator moveGenerator;
+    ChessMoveHistory moveHistory;
+    ChessStaticExchangeEvaluator staticExchangeEvaluator;
+
+    //Every result is folded in here, so the compiler can't drop the work being timed
+    std::uint64_t checksum = 0;
+
+    void addPosition(const ChessBoard& board);
+
+    template <class Operation>
+    MicroBenchmarkResult measure(const std::string& name, Operation operation);
+public:
+    ChessMicroBenchmark(std::uint32_t sampleCount = 10);
+    ~ChessMicroBenchmark() = default;
+
+    //Each position is added along with every position one legal move away
+    void addFen(const std::string& fen);
+    void addDefaultPositions();
+    bool loadPositions(const std::string& fileName);
+
+    std::uint64_t getChecksum() const;
+    const std::vector<std::string>& getFens() const;
+    std::size_t size() const;
+
+    std::vector<MicroBenchmarkResult> run();
+
+    static void print(const std::vector<MicroBenchmarkResult>& results);
+};
@@ -27,6 +27,7 @@
 #include "../types/piecetype.h"
 #include "../types/square.h"
 
+#include "magics.h"
 #include "moves.h"
 
 template <PieceType pieceType>
@@ -99,21 +100,6 @@ constexpr std::uint64_t Magics[PieceType::PIECETYPE_COUNT][Square::SQUARE_COUNT]
     }
 };
 
-struct Magic {
-    const Bitboard magic;
-    const Bitboard mask;
-    const std::uint32_t shift;
-    const std::uint32_t attacks;
-
-    constexpr std::uint32_t index(Bitboard occupied) const {
-#ifdef __BMI2__
-        return static_cast<std::uint32_t>(Pext(occupied, mask));
-#else
-        return static_cast<std::uint32_t>(((occupied & mask) * magic) >> shift);
-#endif
-    }
-};
-
 std::array<Magic, Square::SQUARE_COUNT> BishopMagicList = { {
     { 0x0030204084015040, 0x0040201008040200, 58,    0 },
     { 0x0082481801004202, 0x0000402010080400, 59,   64 },
@@ -248,7 +234,7 @@ std::array<Magic, Square::SQUARE_COUNT> RookMagicList = { {
     { 0x10000a2109418402, 0x7e80808080808000, 52, 98304 }
 } };
 
-template <PieceType pieceType, std::uint32_t attackTableSize>
+template <PieceType pieceType, std::uint32_t attackTableSize, MagicIndexing indexing = MagicIndexing::MULTIPLY>
 constexpr void InitializeAttackTable(std::array<Bitboard, attackTableSize>& attackTable) {
     const std::array<Magic, Square::SQUARE_COUNT>& magics = pieceType == PieceType::BISHOP ? BishopMagicList : RookMagicList;
 
@@ -258,7 +244,7 @@ constexpr void InitializeAttackTable(std::array<Bitboard, attackTableSize>& atta
         Bitboard allPieces = EmptyBitboard;
 
         do {
-            const std::uint32_t index = m.index(allPieces);
+            const std::uint32_t index = indexing == MagicIndexing::PEXT ? m.pextIndex(allPieces) : m.multiplyIndex(allPieces);
             attackTable[m.attacks + index] = SlidingAttacks<pieceType>(src, allPieces);
 
             allPieces = (allPieces - m.mask) & m.mask;
@@ -283,3 +269,18 @@ std::array<Bitboard, 0x19000> RookAttackTable
 
     return result;
 }() };
+
+//The tables above are built for multiply indexing at compile time, and rebuilt here when pext is the faster choice
+static MagicIndexing SelectMagicIndexing()
+{
+    if (!GetCpuFeatures().fastPext) {
+        return MagicIndexing::MULTIPLY;
+    }
+
+    InitializeAttackTable<PieceType::BISHOP, 0x1480, MagicIndexing::PEXT>(BishopAttackTable);
+    InitializeAttackTable<PieceType::ROOK, 0x19000, MagicIndexing::PEXT>(RookAttackTable);
+
+    return MagicIndexing::PEXT;
+}
+
+MagicIndexing SliderIndexing = SelectMagicIndexing();
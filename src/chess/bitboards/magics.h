@@ -18,24 +18,44 @@
 
 #pragma once
 
+#include <type_traits>
+
 #include <cstdint>
 
+#include "../../game/math/cpufeatures.h"
+
 #include "../../game/types/bitboard.h"
 
 #include "../types/square.h"
 
+//The attack tables are laid out for one way of indexing them, picked at startup from the cpu
+enum class MagicIndexing : std::uint8_t {
+    MULTIPLY,
+    PEXT
+};
+
+extern MagicIndexing SliderIndexing;
+
 struct Magic {
     const Bitboard magic;
     const Bitboard mask;
     const std::uint32_t shift;
     const std::uint32_t attacks;
 
-    constexpr std::uint32_t index(Bitboard occupied) const {
-#ifdef __BMI2__
-        return static_cast<std::uint32_t>(Pext(occupied, mask));
-#else
+    constexpr std::uint32_t multiplyIndex(Bitboard occupied) const {
         return static_cast<std::uint32_t>(((occupied & mask) * magic) >> shift);
-#endif
+    }
+
+    std::uint32_t pextIndex(Bitboard occupied) const {
+        return static_cast<std::uint32_t>(PextInstruction(occupied, mask));
+    }
+
+    constexpr std::uint32_t index(Bitboard occupied) const {
+        if (!std::is_constant_evaluated() && SliderIndexing == MagicIndexing::PEXT) {
+            return pextIndex(occupied);
+        }
+
+        return multiplyIndex(occupied);
     }
 };
 
@@ -25,6 +25,7 @@
 #include "../bitboards/moves.h"
 
 #include "../../game/math/bitscan.h"
+#include "../../game/math/popcount.h"
 
 #include "../types/attackboards.h"
 #include "../types/bitboard.h"
@@ -66,7 +67,7 @@ public:
             if (inBetween == EmptyBitboard) {
                 attackBoards.checkingPieces |= OneShiftedBy(src);
             }
-            else if (std::popcount(inBetween) == 1) {
+            else if (PopCount(inBetween) == 1) {
                 attackBoards.blockedPieces |= OneShiftedBy(src);
                 attackBoards.pinnedPieces |= inBetween;
             }
@@ -83,7 +84,7 @@ public:
             if (inBetween == EmptyBitboard) {
                 attackBoards.checkingPieces |= OneShiftedBy(src);
             }
-            else if (std::popcount(inBetween) == 1) {
+            else if (PopCount(inBetween) == 1) {
                 attackBoards.blockedPieces |= OneShiftedBy(src);
                 attackBoards.pinnedPieces |= inBetween;
             }
@@ -101,6 +101,11 @@ void ChessBoard::initFromFen(const std::string& fen)
 
     ss >> std::skipws >> this->fiftyMoveCount >> this->fullMoveCount;
 
+    this->initFromMailbox();
+}
+
+void ChessBoard::initFromMailbox()
+{
     this->buildBitboardsFromMailbox();
 
     this->materialEvaluation = this->calculateMaterialEvaluation();
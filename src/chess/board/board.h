@@ -47,8 +47,7 @@
 #include "../types/piecetype.h"
 #include "../types/score.h"
 
-extern ChessEvaluation MaterialParameters[PieceType::PIECETYPE_COUNT];
-extern ChessEvaluation PstParameters[PieceType::PIECETYPE_COUNT][Square::SQUARE_COUNT];
+#include "../eval/parameters.h"
 
 class ChessBoard : public GameBoard<ChessBoard, ChessMove>
 {
@@ -149,7 +148,7 @@ public:
             const Bitboard* sideToMovePieces = whiteColor ? this->whitePieces : this->blackPieces;
 
             for (PieceType pieceType = PieceType::PAWN; pieceType <= PieceType::KING; pieceType++) {
-                const std::uint32_t pieceTypeCount = std::popcount(sideToMovePieces[pieceType]);
+                const std::uint32_t pieceTypeCount = PopCount(sideToMovePieces[pieceType]);
 
                 result ^= PieceHash(color, pieceType, static_cast<Square>(pieceTypeCount));
             }
@@ -158,13 +157,13 @@ public:
         return result;
     }
 
-    constexpr ChessEvaluation calculateMaterialEvaluation() const
+    constexpr ChessEvaluation calculateMaterialEvaluation(const EvalParameters& evalParameters = DefaultEvalParameters) const
     {
         ChessEvaluation result = { ZERO_SCORE, ZERO_SCORE };
 
         for (PieceType piece = PieceType::PAWN; piece < PieceType::KING; piece++) {
-            result += MaterialParameters[piece] * std::popcount(this->whitePieces[piece]);
-            result -= MaterialParameters[piece] * std::popcount(this->blackPieces[piece]);
+            result += evalParameters.material[piece] * PopCount(this->whitePieces[piece]);
+            result -= evalParameters.material[piece] * PopCount(this->blackPieces[piece]);
         }
 
         return result;
@@ -189,7 +188,7 @@ public:
         return result;
     }
 
-    constexpr ChessEvaluation calculatePstEvaluation() const
+    constexpr ChessEvaluation calculatePstEvaluation(const EvalParameters& evalParameters = DefaultEvalParameters) const
     {
         ChessEvaluation result = { ZERO_SCORE, ZERO_SCORE };
 
@@ -205,7 +204,7 @@ public:
                 for (const Square src : SquareBitboardIterator(srcSquares)) {
                     const Square evaluatedSrc = whiteColor ? src : FlipSquareOnHorizontalLine(src);
 
-                    result += multiplier * PstParameters[piece][evaluatedSrc];
+                    result += multiplier * evalParameters.pst[piece][evaluatedSrc];
                 }
             }
         }
@@ -261,6 +260,9 @@ public:
 
     void initFromFen(const std::string& fen);
 
+    //Everything else follows from the mailbox, the color bitboards and the side, castle and en passant state
+    void initFromMailbox();
+
     constexpr bool isWhiteToMove() const
     {
         return this->sideToMove == Color::WHITE;
@@ -278,12 +280,12 @@ public:
 
     constexpr std::int32_t getPhase() const
     {
-        return std::popcount(this->allPieces);
+        return PopCount(this->allPieces);
     }
 
     constexpr std::int32_t getPieceCount() const
     {
-        return std::popcount(this->allPieces);
+        return PopCount(this->allPieces);
     }
 
     constexpr Square blackKingPosition() const
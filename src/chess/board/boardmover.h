@@ -20,7 +20,9 @@
 
 #include "board.h"
 
+#include "../../game/clock/profiler.h"
 #include "../../game/types/color.h"
+#include "../../game/math/popcount.h"
 #include "../../game/math/shift.h"
 
 #include "../types/bitboard.h"
@@ -32,16 +34,20 @@
 
 #include "../bitboards/moves.h"
 
+#include "../eval/parameters.h"
+
 class ChessBoardMover
 {
+protected:
+    const EvalParameters* evalParameters = &DefaultEvalParameters;
 public:
     constexpr ChessBoardMover() = default;
     constexpr ~ChessBoardMover() = default;
 
     constexpr void assertBoard(const ChessBoard& board) const
     {
-        assert(board.materialEvaluation == board.calculateMaterialEvaluation());
-        assert(board.pstEvaluation == board.calculatePstEvaluation());
+        assert(board.materialEvaluation == board.calculateMaterialEvaluation(*this->evalParameters));
+        assert(board.pstEvaluation == board.calculatePstEvaluation(*this->evalParameters));
 
         assert(board.hashValue == board.calculateHash());
         assert(board.materialHashValue == board.calculateMaterialHash());
@@ -51,6 +57,8 @@ public:
     template <bool performPreCalculations = true>
     constexpr void dispatchDoMove(ChessBoard& board, ChessMove& move) const
     {
+        const ScopedCycleProfile cycleProfile(ProfilePhase::DO_MOVE);
+
         const bool isWhiteToMove = board.sideToMove == Color::WHITE;
 
         if (isWhiteToMove) {
@@ -100,12 +108,12 @@ public:
                 board.pawnHashValue ^= PieceHash(otherColor, PieceType::PAWN, dst + dir);
 
                 if (isWhiteToMove) {
-                    board.pstEvaluation += multiplier * PstParameters[PieceType::PAWN][FlipSquareOnHorizontalLine(dst + dir)];
-                    board.pstEvaluation -= multiplier * PstParameters[PieceType::PAWN][FlipSquareOnHorizontalLine(dst)];
+                    board.pstEvaluation += multiplier * this->evalParameters->pst[PieceType::PAWN][FlipSquareOnHorizontalLine(dst + dir)];
+                    board.pstEvaluation -= multiplier * this->evalParameters->pst[PieceType::PAWN][FlipSquareOnHorizontalLine(dst)];
                 }
                 else {
-                    board.pstEvaluation += multiplier * PstParameters[PieceType::PAWN][dst + dir];
-                    board.pstEvaluation -= multiplier * PstParameters[PieceType::PAWN][dst];
+                    board.pstEvaluation += multiplier * this->evalParameters->pst[PieceType::PAWN][dst + dir];
+                    board.pstEvaluation -= multiplier * this->evalParameters->pst[PieceType::PAWN][dst];
                 }
             }
         }
@@ -122,12 +130,12 @@ public:
 
         if (performPreCalculations) {
             if (isWhiteToMove) {
-                board.pstEvaluation += multiplier * PstParameters[movingPiece][dst];
-                board.pstEvaluation -= multiplier * PstParameters[movingPiece][src];
+                board.pstEvaluation += multiplier * this->evalParameters->pst[movingPiece][dst];
+                board.pstEvaluation -= multiplier * this->evalParameters->pst[movingPiece][src];
             }
             else {
-                board.pstEvaluation += multiplier * PstParameters[movingPiece][FlipSquareOnHorizontalLine(dst)];
-                board.pstEvaluation -= multiplier * PstParameters[movingPiece][FlipSquareOnHorizontalLine(src)];
+                board.pstEvaluation += multiplier * this->evalParameters->pst[movingPiece][FlipSquareOnHorizontalLine(dst)];
+                board.pstEvaluation -= multiplier * this->evalParameters->pst[movingPiece][FlipSquareOnHorizontalLine(src)];
             }
 
             board.hashValue ^= PieceHash(colorToMove, movingPiece, src);
@@ -195,8 +203,8 @@ public:
                     board.pieces[Square::H1] = PieceType::NO_PIECE;
 
                     if (performPreCalculations) {
-                        board.pstEvaluation += multiplier * PstParameters[PieceType::ROOK][Square::F1];
-                        board.pstEvaluation -= multiplier * PstParameters[PieceType::ROOK][Square::H1];
+                        board.pstEvaluation += multiplier * this->evalParameters->pst[PieceType::ROOK][Square::F1];
+                        board.pstEvaluation -= multiplier * this->evalParameters->pst[PieceType::ROOK][Square::H1];
 
                         board.hashValue ^= PieceHash(Color::WHITE, PieceType::ROOK, Square::F1);
                         board.hashValue ^= PieceHash(Color::WHITE, PieceType::ROOK, Square::H1);
@@ -211,8 +219,8 @@ public:
                     board.pieces[Square::A1] = PieceType::NO_PIECE;
 
                     if (performPreCalculations) {
-                        board.pstEvaluation += multiplier * PstParameters[PieceType::ROOK][Square::D1];
-                        board.pstEvaluation -= multiplier * PstParameters[PieceType::ROOK][Square::A1];
+                        board.pstEvaluation += multiplier * this->evalParameters->pst[PieceType::ROOK][Square::D1];
+                        board.pstEvaluation -= multiplier * this->evalParameters->pst[PieceType::ROOK][Square::A1];
 
                         board.hashValue ^= PieceHash(Color::WHITE, PieceType::ROOK, Square::D1);
                         board.hashValue ^= PieceHash(Color::WHITE, PieceType::ROOK, Square::A1);
@@ -232,8 +240,8 @@ public:
                     board.pieces[Square::H8] = PieceType::NO_PIECE;
 
                     if (performPreCalculations) {
-                        board.pstEvaluation += multiplier * PstParameters[PieceType::ROOK][FlipSquareOnHorizontalLine(Square::F8)];
-                        board.pstEvaluation -= multiplier * PstParameters[PieceType::ROOK][FlipSquareOnHorizontalLine(Square::H8)];
+                        board.pstEvaluation += multiplier * this->evalParameters->pst[PieceType::ROOK][FlipSquareOnHorizontalLine(Square::F8)];
+                        board.pstEvaluation -= multiplier * this->evalParameters->pst[PieceType::ROOK][FlipSquareOnHorizontalLine(Square::H8)];
 
                         board.hashValue ^= PieceHash(Color::BLACK, PieceType::ROOK, Square::F8);
                         board.hashValue ^= PieceHash(Color::BLACK, PieceType::ROOK, Square::H8);
@@ -248,8 +256,8 @@ public:
                     board.pieces[Square::A8] = PieceType::NO_PIECE;
 
                     if (performPreCalculations) {
-                        board.pstEvaluation += multiplier * PstParameters[PieceType::ROOK][FlipSquareOnHorizontalLine(Square::D8)];
-                        board.pstEvaluation -= multiplier * PstParameters[PieceType::ROOK][FlipSquareOnHorizontalLine(Square::A8)];
+                        board.pstEvaluation += multiplier * this->evalParameters->pst[PieceType::ROOK][FlipSquareOnHorizontalLine(Square::D8)];
+                        board.pstEvaluation -= multiplier * this->evalParameters->pst[PieceType::ROOK][FlipSquareOnHorizontalLine(Square::A8)];
 
                         board.hashValue ^= PieceHash(Color::BLACK, PieceType::ROOK, Square::D8);
                         board.hashValue ^= PieceHash(Color::BLACK, PieceType::ROOK, Square::A8);
@@ -267,16 +275,16 @@ public:
         //5) Change the capturedpiece bitboard
         if (capturedPiece != PieceType::NO_PIECE) {
             if (performPreCalculations) {
-                board.materialEvaluation += multiplier * MaterialParameters[capturedPiece];
+                board.materialEvaluation += multiplier * this->evalParameters->material[capturedPiece];
 
-                std::uint32_t pieceTypeCount = std::popcount(otherPieces[capturedPiece]);
+                std::uint32_t pieceTypeCount = PopCount(otherPieces[capturedPiece]);
                 board.materialHashValue ^= PieceHash(otherColor, capturedPiece, static_cast<Square>(pieceTypeCount)) ^ PieceHash(otherColor, capturedPiece, static_cast<Square>(pieceTypeCount - 1));
 
                 if (isWhiteToMove) {
-                    board.pstEvaluation += multiplier * PstParameters[capturedPiece][FlipSquareOnHorizontalLine(dst)];
+                    board.pstEvaluation += multiplier * this->evalParameters->pst[capturedPiece][FlipSquareOnHorizontalLine(dst)];
                 }
                 else {
-                    board.pstEvaluation += multiplier * PstParameters[capturedPiece][dst];
+                    board.pstEvaluation += multiplier * this->evalParameters->pst[capturedPiece][dst];
                 }
 
                 board.hashValue ^= PieceHash(otherColor, capturedPiece, dst);
@@ -319,22 +327,22 @@ public:
             board.pieces[dst] = promotionPiece;
 
             if (performPreCalculations) {
-                board.materialEvaluation += multiplier * MaterialParameters[promotionPiece];
-                board.materialEvaluation -= multiplier * MaterialParameters[PieceType::PAWN];
+                board.materialEvaluation += multiplier * this->evalParameters->material[promotionPiece];
+                board.materialEvaluation -= multiplier * this->evalParameters->material[PieceType::PAWN];
 
-                std::uint32_t pieceTypeCount = std::popcount(piecesToMove[promotionPiece]);
+                std::uint32_t pieceTypeCount = PopCount(piecesToMove[promotionPiece]);
                 board.materialHashValue ^= PieceHash(colorToMove, promotionPiece, static_cast<Square>(pieceTypeCount)) ^ PieceHash(colorToMove, promotionPiece, static_cast<Square>(pieceTypeCount + 1));
 
-                pieceTypeCount = std::popcount(piecesToMove[PieceType::PAWN]);
+                pieceTypeCount = PopCount(piecesToMove[PieceType::PAWN]);
                 board.materialHashValue ^= PieceHash(colorToMove, PieceType::PAWN, static_cast<Square>(pieceTypeCount)) ^ PieceHash(colorToMove, PieceType::PAWN, static_cast<Square>(pieceTypeCount - 1));
 
                 if (isWhiteToMove) {
-                    board.pstEvaluation += multiplier * PstParameters[promotionPiece][dst];
-                    board.pstEvaluation -= multiplier * PstParameters[PieceType::PAWN][dst];
+                    board.pstEvaluation += multiplier * this->evalParameters->pst[promotionPiece][dst];
+                    board.pstEvaluation -= multiplier * this->evalParameters->pst[PieceType::PAWN][dst];
                 }
                 else {
-                    board.pstEvaluation += multiplier * PstParameters[promotionPiece][FlipSquareOnHorizontalLine(dst)];
-                    board.pstEvaluation -= multiplier * PstParameters[PieceType::PAWN][FlipSquareOnHorizontalLine(dst)];
+                    board.pstEvaluation += multiplier * this->evalParameters->pst[promotionPiece][FlipSquareOnHorizontalLine(dst)];
+                    board.pstEvaluation -= multiplier * this->evalParameters->pst[PieceType::PAWN][FlipSquareOnHorizontalLine(dst)];
                 }
 
                 board.hashValue ^= PieceHash(colorToMove, PieceType::PAWN, dst);
@@ -392,6 +400,8 @@ public:
 
     bool doNullMove(ChessBoard& board) const
     {
+        const ScopedCycleProfile cycleProfile(ProfilePhase::DO_MOVE);
+
         board.hashValue ^= WhiteToMoveHash;
         board.sideToMove = ~board.sideToMove;
 
@@ -407,4 +417,10 @@ public:
 
         return true;
     }
+
+    //Boards moved here have to have had their material and piece square scores calculated with the same parameters
+    constexpr void setEvalParameters(const EvalParameters* evalParameters)
+    {
+        this->evalParameters = evalParameters;
+    }
 };
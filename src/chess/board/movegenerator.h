@@ -24,6 +24,7 @@
 
 #include <cassert>
 
+#include "../../game/clock/profiler.h"
 #include "../../game/types/depth.h"
 #include "../types/move.h"
 #include "../types/piecetype.h"
@@ -37,6 +38,7 @@
 #include "../bitboards/moves.h"
 
 #include "../../game/math/bitscan.h"
+#include "../../game/math/popcount.h"
 
 class ChessMoveGenerator
 {
@@ -79,6 +81,8 @@ public:
 
     constexpr NodeCount DispatchGenerateAllCaptures(const ChessBoard& board, ChessMoveList& moveList) const
     {
+        const ScopedCycleProfile cycleProfile(ProfilePhase::MOVE_GENERATION);
+
         const bool isWhiteToMove = board.isWhiteToMove();
 
         if (isWhiteToMove) {
@@ -91,6 +95,8 @@ public:
 
     constexpr NodeCount DispatchGenerateAllMoves(const ChessBoard& board, ChessMoveList& moveList) const
     {
+        const ScopedCycleProfile cycleProfile(ProfilePhase::MOVE_GENERATION);
+
         const bool isWhiteToMove = board.isWhiteToMove();
 
         if (isWhiteToMove) {
@@ -314,7 +320,7 @@ public:
 
         //2) Find which pieces are attacking the king.  If two pieces are checking the king, return the current list since
         //	only moves which move the king himself are able to evade two checking pieces.
-        if (std::popcount(attackBoards.checkingPieces) == 2) {
+        if (PopCount(attackBoards.checkingPieces) == 2) {
             return moveList.size();
         }
 
@@ -549,7 +555,7 @@ public:
                 for (const Square rookOrQueenSrc : SquareBitboardIterator(otherRooksAndQueens)) {
                     const Bitboard inBetween = InBetween(rookOrQueenSrc, kingPosition);
                     if ((inBetween & OneShiftedBy(src)) == EmptyBitboard
-                        || std::popcount(inBetween & board.allPieces) > 2) {
+                        || PopCount(inBetween & board.allPieces) > 2) {
 
                         //If either a or b are true, this rook or queen will not attack the king and does not pin the
                         //  pawns.
@@ -681,7 +687,7 @@ public:
                 }
             }
 
-            result += std::popcount(dstMoves);
+            result += PopCount(dstMoves);
 
             if (!countOnly) {
                 for (const Square dst : SquareBitboardIterator(dstMoves)) {
@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include "../../game/clock/profiler.h"
+
 #include "attackgenerator.h"
 
 #include "../types/nodetype.h"
@@ -42,6 +44,8 @@ public:
 
     void reorderMoves(const ChessBoard& board, ChessMoveList& moveList, const ChessSearchStack* searchStack, const PieceTypeSquareHistoryTable& historyTable, const SquareSquareHistoryTable(&mateHistoryTable)[2]) const
     {
+        const ScopedCycleProfile cycleProfile(ProfilePhase::MOVE_ORDERING);
+
         const bool isWhiteToMove = board.isWhiteToMove();
 
         const Bitboard* otherPieces = isWhiteToMove ? board.blackPieces : board.whitePieces;
@@ -127,6 +131,8 @@ public:
 
     void reorderQuiescenceMoves(const ChessBoard& board, ChessMoveList& moveList, const ChessSearchStack* searchStack) const
     {
+        const ScopedCycleProfile cycleProfile(ProfilePhase::MOVE_ORDERING);
+
         const bool isWhiteToMove = board.isWhiteToMove();
 
         const Bitboard* otherPieces = isWhiteToMove ? board.blackPieces : board.whitePieces;
@@ -142,8 +148,8 @@ public:
             const PieceType& movingPiece = board.pieces[src];
             const PieceType& capturedPiece = board.pieces[dst];
 
-            const Evaluation capturedPieceEvaluation = MaterialParameters[capturedPiece];
-            const Evaluation movingPieceEvaluation = MaterialParameters[movingPiece];
+            const Evaluation capturedPieceEvaluation = DefaultEvalParameters.material[capturedPiece];
+            const Evaluation movingPieceEvaluation = DefaultEvalParameters.material[movingPiece];
             const Score mvvlvaScore = capturedPieceEvaluation.mg - movingPieceEvaluation.mg;
 
             move.seeScore = INVALID_SCORE;
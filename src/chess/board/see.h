@@ -22,6 +22,7 @@
 
 #include "board.h"
 
+#include "../../game/clock/profiler.h"
 #include "../../game/types/color.h"
 
 #include "../types/piecetype.h"
@@ -51,6 +52,8 @@ public:
 
     constexpr Score staticExchangeEvaluation(const ChessBoard& board, Square src, Square dst) const
     {
+        const ScopedCycleProfile cycleProfile(ProfilePhase::STATIC_EXCHANGE_EVALUATION);
+
         bool isWhiteToMove = board.isWhiteToMove();
 
         const PieceType movingPiece = board.pieces[src];
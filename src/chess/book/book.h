@@ -3,9 +3,11 @@
 #include "../../game/book/book.h"
 
 #include "../board/board.h"
+#include "../board/boardmover.h"
 
 #include "../types/move.h"
 
+//Results are counted for the side that moved into the position
 struct ChessBookPosition
 {
 	Hash hashValue;
@@ -25,4 +27,4 @@ static ChessBookPosition& operator += (ChessBookPosition& bp1, ChessBookPosition
 	return bp1;
 }
 
-typedef Book<ChessBoard, ChessBookPosition> ChessBook;
+typedef Book<ChessBoard, ChessBoardMover, ChessBookPosition> ChessBook;
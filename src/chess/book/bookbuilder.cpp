@@ -0,0 +1,314 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <queue>
+#include <sstream>
+
+#include "bookbuilder.h"
+#include "pgn.h"
+
+#include "../board/boardmover.h"
+
+//A book entry is a fixed size record, read and written as is
+static_assert(sizeof(ChessBookPosition) == sizeof(Hash) + 4 * sizeof(GameResultCount));
+
+static void CountBookPosition(std::unordered_map<Hash, ChessBookPosition>& positions, Hash hashValue, TwoPlayerGameResult moverResult)
+{
+    ChessBookPosition& bookPosition = positions[hashValue];
+
+    bookPosition.hashValue = hashValue;
+    bookPosition.winCount += moverResult == TwoPlayerGameResult::WIN ? 1 : 0;
+    bookPosition.drawCount += moverResult == TwoPlayerGameResult::DRAW ? 1 : 0;
+    bookPosition.lossCount += moverResult == TwoPlayerGameResult::LOSS ? 1 : 0;
+    bookPosition.gameCount++;
+}
+
+ChessBookBuilder::ChessBookBuilder(const std::string& bookFileName, std::uint32_t maxPlies, std::size_t maxPositionsInMemory, std::uint32_t threadCount)
+    : threadPool(threadCount), bookFileName(bookFileName), maxPlies(maxPlies), maxPositionsInMemory(maxPositionsInMemory)
+{
+}
+
+void ChessBookBuilder::addPositions(BookPositionMap& positions)
+{
+    //1) Group the positions by shard, so each shard is locked once per batch
+    std::array<std::vector<ChessBookPosition>, ShardCount> shardPositions;
+
+    for (const auto& [hashValue, bookPosition] : positions) {
+        shardPositions[hashValue % ShardCount].push_back(bookPosition);
+    }
+
+    //2) Then add them in
+    for (std::uint32_t shard = 0; shard < ShardCount; shard++) {
+        std::lock_guard<std::mutex> lock(this->shards[shard].mutex);
+
+        for (const ChessBookPosition& bookPosition : shardPositions[shard]) {
+            ChessBookPosition& shardPosition = this->shards[shard].positions[bookPosition.hashValue];
+
+            shardPosition.hashValue = bookPosition.hashValue;
+            shardPosition += bookPosition;
+        }
+    }
+}
+
+std::size_t ChessBookBuilder::getPositionCount()
+{
+    std::size_t result = 0;
+
+    for (BookShard& shard : this->shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        result += shard.positions.size();
+    }
+
+    return result;
+}
+
+bool ChessBookBuilder::spillRun()
+{
+    //1) Sort everything in memory by hash
+    std::vector<ChessBookPosition> run;
+    run.reserve(this->getPositionCount());
+
+    for (BookShard& shard : this->shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        for (const auto& [hashValue, bookPosition] : shard.positions) {
+            run.push_back(bookPosition);
+        }
+
+        shard.positions = {};
+    }
+
+    std::sort(run.begin(), run.end(), [](const ChessBookPosition& bp1, const ChessBookPosition& bp2) { return bp1.hashValue < bp2.hashValue; });
+
+    //2) And write it out as a run, in the same format as the book itself
+    const std::string runFileName = this->bookFileName + ".run" + std::to_string(this->runFileNames.size());
+    std::ofstream runFile(runFileName, std::ios::binary | std::ios::trunc);
+
+    runFile.write(reinterpret_cast<const char*>(run.data()), run.size() * sizeof(ChessBookPosition));
+
+    if (!runFile) {
+        std::cout << "Unable to write " << runFileName << std::endl;
+        return false;
+    }
+
+    this->runFileNames.push_back(runFileName);
+
+    return true;
+}
+
+bool ChessBookBuilder::mergeRuns()
+{
+    struct RunHead {
+        ChessBookPosition bookPosition;
+        std::size_t run;
+
+        bool operator < (const RunHead& other) const
+        {
+            return this->bookPosition.hashValue > other.bookPosition.hashValue;
+        }
+    };
+
+    std::vector<std::unique_ptr<std::ifstream>> runFiles;
+    std::priority_queue<RunHead> runHeads;
+
+    //1) Start with the first position of every run
+    for (std::size_t run = 0; run < this->runFileNames.size(); run++) {
+        runFiles.push_back(std::make_unique<std::ifstream>(this->runFileNames[run], std::ios::binary));
+
+        RunHead runHead = { {}, run };
+
+        if (runFiles[run]->read(reinterpret_cast<char*>(&runHead.bookPosition), sizeof(ChessBookPosition))) {
+            runHeads.push(runHead);
+        }
+    }
+
+    std::ofstream bookFile(this->bookFileName, std::ios::binary | std::ios::trunc);
+
+    //2) Always take the lowest hash, adding up the counts of the same position from different runs
+    while (!runHeads.empty()) {
+        RunHead runHead = runHeads.top();
+        runHeads.pop();
+
+        ChessBookPosition bookPosition = runHead.bookPosition;
+
+        while (true) {
+            if (runFiles[runHead.run]->read(reinterpret_cast<char*>(&runHead.bookPosition), sizeof(ChessBookPosition))) {
+                runHeads.push(runHead);
+            }
+
+            if (runHeads.empty() || runHeads.top().bookPosition.hashValue != bookPosition.hashValue) {
+                break;
+            }
+
+            runHead = runHeads.top();
+            runHeads.pop();
+
+            bookPosition += runHead.bookPosition;
+        }
+
+        bookFile.write(reinterpret_cast<const char*>(&bookPosition), sizeof(ChessBookPosition));
+    }
+
+    runFiles.clear();
+
+    for (const std::string& runFileName : this->runFileNames) {
+        std::remove(runFileName.c_str());
+    }
+
+    this->runFileNames.clear();
+
+    return static_cast<bool>(bookFile);
+}
+
+template <typename Record, typename Reader, typename Counter>
+bool ChessBookBuilder::addRecords(Reader reader, Counter counter)
+{
+    bool isReading = true;
+
+    while (isReading) {
+        //1) Read a couple of batches per thread, and count their positions in parallel
+        for (std::uint32_t i = 0; i < 2 * this->threadPool.size() && isReading; i++) {
+            std::shared_ptr<std::vector<Record>> batch = std::make_shared<std::vector<Record>>();
+            batch->reserve(GamesPerBatch);
+
+            Record record;
+
+            while (batch->size() < GamesPerBatch && (isReading = reader(record))) {
+                batch->push_back(std::move(record));
+            }
+
+            this->gameCount += batch->size();
+
+            this->threadPool.submit([this, batch, counter]() {
+                BookPositionMap positions;
+
+                for (const Record& batchRecord : *batch) {
+                    if (!counter(batchRecord, positions)) {
+                        this->skippedGameCount++;
+                    }
+                }
+
+                this->addPositions(positions);
+            });
+        }
+
+        this->threadPool.wait();
+
+        //2) Keep memory bounded by moving what's been counted so far to disk
+        if (this->getPositionCount() > this->maxPositionsInMemory
+            && !this->spillRun()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ChessBookBuilder::addPgnFile(const std::string& fileName)
+{
+    std::ifstream file(fileName);
+
+    if (!file) {
+        return false;
+    }
+
+    PgnReader pgnReader(file);
+
+    return this->addRecords<PgnGame>([&pgnReader](PgnGame& game) { return pgnReader.readGame(game); },
+        [this](const PgnGame& game, BookPositionMap& positions) {
+            const ChessBoardMover boardMover;
+
+            ChessBoard board;
+            ChessMoveList moveList;
+            TwoPlayerGameResult whiteResult;
+
+            //A game that stops making sense partway still has good moves up to there
+            const bool isParsed = ParsePgnGame(game, board, moveList);
+
+            if (!ParsePgnResult(game.result, whiteResult) || moveList.empty()) {
+                return false;
+            }
+
+            for (std::size_t ply = 0; ply < moveList.size() && ply < this->maxPlies; ply++) {
+                const TwoPlayerGameResult moverResult = board.sideToMove == Color::WHITE ? whiteResult : -whiteResult;
+
+                boardMover.dispatchDoMove(board, moveList[ply]);
+
+                CountBookPosition(positions, board.hashValue, moverResult);
+            }
+
+            return isParsed;
+        });
+}
+
+bool ChessBookBuilder::addPositionFile(const std::string& fileName)
+{
+    std::ifstream file(fileName);
+
+    if (!file) {
+        return false;
+    }
+
+    //epoch,random,fen,result,depth,score,nodecount,principal variation
+    return this->addRecords<std::string>([&file](std::string& line) { return static_cast<bool>(std::getline(file, line)); },
+        [this](const std::string& line, BookPositionMap& positions) {
+            std::stringstream ss(line);
+            std::string epoch, random, fen, result;
+
+            if (!std::getline(ss, epoch, ',') || !std::getline(ss, random, ',')
+                || !std::getline(ss, fen, ',') || !std::getline(ss, result, ',')) {
+                return false;
+            }
+
+            //The result is for the side to move, and the book counts it for the side that moved into the position
+            TwoPlayerGameResult moverResult;
+
+            if (result == "1.0") {
+                moverResult = TwoPlayerGameResult::LOSS;
+            }
+            else if (result == "0.5") {
+                moverResult = TwoPlayerGameResult::DRAW;
+            }
+            else if (result == "0.0") {
+                moverResult = TwoPlayerGameResult::WIN;
+            }
+            else {
+                return false;
+            }
+
+            ChessBoard board;
+            board.resetSpecificPosition(fen);
+
+            CountBookPosition(positions, board.hashValue, moverResult);
+
+            return true;
+        });
+}
+
+bool ChessBookBuilder::save()
+{
+    if (!this->spillRun()) {
+        return false;
+    }
+
+    return this->mergeRuns();
+}
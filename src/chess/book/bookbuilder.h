@@ -0,0 +1,94 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <cstdint>
+
+#include "book.h"
+
+#include "../../game/threads/threadpool.h"
+
+//Plies of each game that make it into the book
+constexpr std::uint32_t DefaultBookBuildPlies = 32;
+
+//About a gigabyte of counts before they're spilled to disk
+constexpr std::size_t DefaultBookBuildPositions = std::size_t(1) << 24;
+
+//Builds a ChessBook file from game collections.  Positions are counted in memory and spilled to sorted runs on disk, which are merged at the end.
+class ChessBookBuilder
+{
+protected:
+    static constexpr std::uint32_t ShardCount = 64;
+
+    //Games parsed by one task
+    static constexpr std::size_t GamesPerBatch = 1024;
+
+    using BookPositionMap = std::unordered_map<Hash, ChessBookPosition>;
+
+    struct BookShard {
+        std::mutex mutex;
+        BookPositionMap positions;
+    };
+
+    ThreadPool threadPool;
+
+    std::array<BookShard, ShardCount> shards;
+
+    std::string bookFileName;
+    std::vector<std::string> runFileNames;
+
+    std::uint32_t maxPlies;
+    std::size_t maxPositionsInMemory;
+
+    std::uint64_t gameCount = 0;
+    std::atomic<std::uint64_t> skippedGameCount = 0;
+
+    void addPositions(BookPositionMap& positions);
+    std::size_t getPositionCount();
+
+    bool spillRun();
+    bool mergeRuns();
+
+    template <typename Record, typename Reader, typename Counter>
+    bool addRecords(Reader reader, Counter counter);
+public:
+    ChessBookBuilder(const std::string& bookFileName, std::uint32_t maxPlies, std::size_t maxPositionsInMemory, std::uint32_t threadCount = 0);
+
+    bool addPgnFile(const std::string& fileName);
+    bool addPositionFile(const std::string& fileName);
+
+    std::uint64_t getGameCount() const
+    {
+        return this->gameCount;
+    }
+
+    std::uint64_t getSkippedGameCount() const
+    {
+        return this->skippedGameCount;
+    }
+
+    bool save();
+};
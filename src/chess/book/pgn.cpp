@@ -0,0 +1,260 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <sstream>
+
+#include "pgn.h"
+
+#include "../board/boardmover.h"
+#include "../board/movegenerator.h"
+
+static const std::string SanPiecePrint = "PNBRQK";
+
+static bool ReadTagValue(const std::string& line, std::string& value)
+{
+    const std::size_t first = line.find('"');
+    const std::size_t last = line.rfind('"');
+
+    if (first == std::string::npos || last <= first) {
+        return false;
+    }
+
+    value = line.substr(first + 1, last - first - 1);
+
+    return true;
+}
+
+bool PgnReader::readGame(PgnGame& game)
+{
+    game.fen.clear();
+    game.result.clear();
+    game.moveText.clear();
+
+    bool inMoveText = false;
+
+    while (this->hasLine || std::getline(this->input, this->line)) {
+        this->hasLine = false;
+
+        if (!this->line.empty() && this->line.back() == '\r') {
+            this->line.pop_back();
+        }
+
+        //1) A tag after the moves starts the next game
+        if (!this->line.empty() && this->line[0] == '[') {
+            if (inMoveText) {
+                this->hasLine = true;
+                return true;
+            }
+
+            if (this->line.compare(0, 5, "[FEN ") == 0) {
+                ReadTagValue(this->line, game.fen);
+            }
+            else if (this->line.compare(0, 8, "[Result ") == 0) {
+                ReadTagValue(this->line, game.result);
+            }
+
+            continue;
+        }
+
+        //2) Everything else is movetext, without the comments that run to the end of the line
+        if (const std::size_t comment = this->line.find(';');
+            comment != std::string::npos && this->line.find('{') > comment) {
+            this->line.resize(comment);
+        }
+
+        if (!this->line.empty()) {
+            inMoveText = true;
+
+            game.moveText += this->line;
+            game.moveText += ' ';
+        }
+    }
+
+    return inMoveText || !game.result.empty();
+}
+
+bool ParseSanMove(const ChessBoard& board, const std::string& san, ChessMove& move)
+{
+    const ChessMoveGenerator moveGenerator;
+
+    ChessMoveList moveList;
+    moveGenerator.DispatchGenerateAllMoves(board, moveList);
+
+    //1) Drop check marks and annotations
+    std::string text = san;
+
+    while (!text.empty() && std::string("+#!?").find(text.back()) != std::string::npos) {
+        text.pop_back();
+    }
+
+    if (text.size() < 2) {
+        return false;
+    }
+
+    //2) Castling is the king moving two files
+    const bool isShortCastle = text == "O-O" || text == "0-0";
+    const bool isLongCastle = text == "O-O-O" || text == "0-0-0";
+
+    if (isShortCastle || isLongCastle) {
+        const Square kingSquare = BitScanForward<Square>(board.sideToMove == Color::WHITE ? board.whitePieces[PieceType::KING] : board.blackPieces[PieceType::KING]);
+        const Square castleSquare = GetFile(kingSquare) == File::_E ? Square(kingSquare + (isShortCastle ? 2 : -2)) : Square::NO_SQUARE;
+
+        for (const ChessMove& legalMove : moveList) {
+            if (legalMove.src == kingSquare && legalMove.dst == castleSquare) {
+                move = legalMove;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    //3) Then the piece, the promotion and the destination
+    PieceType pieceType = PieceType::PAWN;
+    PieceType promotionPiece = PieceType::NO_PIECE;
+
+    if (const std::size_t piece = SanPiecePrint.find(text[0]); piece != std::string::npos && piece > 0) {
+        pieceType = PieceType(PieceType::PAWN + piece);
+        text.erase(0, 1);
+    }
+
+    if (const std::size_t promotion = SanPiecePrint.find(text.back()); pieceType == PieceType::PAWN && promotion != std::string::npos) {
+        promotionPiece = PieceType(PieceType::PAWN + promotion);
+        text.pop_back();
+
+        if (!text.empty() && text.back() == '=') {
+            text.pop_back();
+        }
+    }
+
+    text.erase(std::remove(text.begin(), text.end(), 'x'), text.end());
+    text.erase(std::remove(text.begin(), text.end(), '-'), text.end());
+
+    if (text.size() < 2) {
+        return false;
+    }
+
+    const std::size_t dstFile = FilePrintLowerCase.find(text[text.size() - 2]);
+    const std::size_t dstRank = RankPrint.find(text[text.size() - 1]);
+
+    if (dstFile == std::string::npos || dstRank == std::string::npos) {
+        return false;
+    }
+
+    const Square dst = File(dstFile) * Rank(dstRank);
+
+    //4) Whatever is left tells apart pieces of the same kind
+    std::size_t srcFile = std::string::npos, srcRank = std::string::npos;
+
+    for (std::size_t i = 0; i + 2 < text.size(); i++) {
+        if (FilePrintLowerCase.find(text[i]) != std::string::npos) {
+            srcFile = FilePrintLowerCase.find(text[i]);
+        }
+        else if (RankPrint.find(text[i]) != std::string::npos) {
+            srcRank = RankPrint.find(text[i]);
+        }
+    }
+
+    std::uint32_t matches = 0;
+
+    for (const ChessMove& legalMove : moveList) {
+        if (legalMove.dst == dst
+            && board.pieceAt(legalMove.src) == pieceType
+            && legalMove.promotionPiece == promotionPiece
+            && (srcFile == std::string::npos || GetFile(legalMove.src) == File(srcFile))
+            && (srcRank == std::string::npos || GetRank(legalMove.src) == Rank(srcRank))) {
+            move = legalMove;
+            matches++;
+        }
+    }
+
+    return matches == 1;
+}
+
+bool ParsePgnResult(const std::string& result, TwoPlayerGameResult& whiteResult)
+{
+    if (result == "1-0") {
+        whiteResult = TwoPlayerGameResult::WIN;
+    }
+    else if (result == "0-1") {
+        whiteResult = TwoPlayerGameResult::LOSS;
+    }
+    else if (result == "1/2-1/2") {
+        whiteResult = TwoPlayerGameResult::DRAW;
+    }
+    else {
+        return false;
+    }
+
+    return true;
+}
+
+bool ParsePgnGame(const PgnGame& game, ChessBoard& board, ChessMoveList& moveList)
+{
+    const ChessBoardMover boardMover;
+
+    if (game.fen.empty()) {
+        board.resetStartingPosition();
+    }
+    else {
+        board.resetSpecificPosition(game.fen);
+    }
+
+    ChessBoard currentBoard = board;
+    moveList.clear();
+
+    //1) Skip comments, variations, move numbers and annotation glyphs
+    std::uint32_t commentDepth = 0, variationDepth = 0;
+    std::string token;
+
+    for (std::size_t i = 0; i <= game.moveText.size(); i++) {
+        const char c = i < game.moveText.size() ? game.moveText[i] : ' ';
+
+        if (commentDepth > 0) {
+            commentDepth -= c == '}' ? 1 : 0;
+            continue;
+        }
+
+        if (c == '{' || c == '(' || c == ')' || isspace(c) || c == '.') {
+            //2) Play every complete move token
+            if (!token.empty() && variationDepth == 0 && !isdigit(token[0]) && token[0] != '$' && token != "*") {
+                ChessMove move;
+
+                if (!ParseSanMove(currentBoard, token, move)) {
+                    return false;
+                }
+
+                boardMover.dispatchDoMove(currentBoard, move);
+                moveList.push_back(move);
+            }
+
+            token.clear();
+
+            commentDepth += c == '{' ? 1 : 0;
+            variationDepth += c == '(' ? 1 : 0;
+            variationDepth -= c == ')' && variationDepth > 0 ? 1 : 0;
+
+            continue;
+        }
+
+        token += c;
+    }
+
+    return true;
+}
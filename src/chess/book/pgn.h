@@ -0,0 +1,55 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <istream>
+#include <string>
+
+#include "../board/board.h"
+
+#include "../types/move.h"
+
+#include "../../game/types/result.h"
+
+//The raw text of one game, split by the reader so it can be parsed on another thread
+struct PgnGame
+{
+    std::string fen;
+    std::string result;
+    std::string moveText;
+};
+
+class PgnReader
+{
+protected:
+    std::istream& input;
+    std::string line;
+
+    bool hasLine = false;
+public:
+    explicit PgnReader(std::istream& input) : input(input) {}
+
+    bool readGame(PgnGame& game);
+};
+
+bool ParseSanMove(const ChessBoard& board, const std::string& san, ChessMove& move);
+bool ParsePgnResult(const std::string& result, TwoPlayerGameResult& whiteResult);
+
+//Finds the starting position and the moves of a game, stopping at the first move that can't be read
+bool ParsePgnGame(const PgnGame& game, ChessBoard& board, ChessMoveList& moveList);
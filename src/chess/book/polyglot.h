@@ -0,0 +1,62 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+#include "../board/board.h"
+
+#include "../types/move.h"
+
+#include "../../game/io/mappedfile.h"
+#include "../../game/types/hash.h"
+
+//Piece, castling, en passant and side to move keys, in the order the Polyglot book format defines them
+constexpr std::size_t PolyglotRandomCount = 781;
+
+bool VerifyPolyglotRandom();
+
+Hash CalculatePolyglotHash(const ChessBoard& board);
+
+//Books are arrays of big endian 16 byte entries, sorted by key
+class PolyglotBook
+{
+protected:
+    static constexpr std::size_t EntrySize = 16;
+
+    MappedFile bookFile;
+    std::size_t entryCount = 0;
+
+    Hash getKey(std::size_t entry) const;
+    std::uint16_t getWord(std::size_t entry, std::size_t offset) const;
+public:
+    bool loadFromFile(const std::string& fileName);
+
+    bool isOpen() const
+    {
+        return this->bookFile.isOpen();
+    }
+
+    //Finds the legal moves the book has for this position, with their weights
+    std::size_t getBookMoves(const ChessBoard& board, ChessMoveList& moveList, std::vector<std::uint32_t>& weights) const;
+};
@@ -0,0 +1,199 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <sstream>
+
+#include "jsonsearcheventhandler.h"
+
+static const char* EventNames[] = { "line", "depth", "search" };
+
+JsonSearchEventHandler::JsonSearchEventHandler(const ChessSearcher& searcher)
+    : searcher(searcher)
+{
+    this->writerThread = std::thread(&JsonSearchEventHandler::writerLoop, this);
+}
+
+JsonSearchEventHandler::~JsonSearchEventHandler()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->eventMutex);
+        this->isStopping = true;
+    }
+
+    this->eventCondition.notify_one();
+    this->writerThread.join();
+}
+
+bool JsonSearchEventHandler::open(const std::string& fileName)
+{
+    std::lock_guard<std::mutex> lock(this->outputFileMutex);
+
+    if (this->outputFile.is_open()) {
+        this->outputFile.close();
+    }
+
+    this->outputFile.clear();
+    this->outputFile.open(fileName, std::ofstream::out | std::ofstream::app);
+
+    return this->outputFile.is_open();
+}
+
+void JsonSearchEventHandler::push(JsonSearchEvent&& event)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->eventMutex);
+        this->eventQueue.push_back(std::move(event));
+    }
+
+    this->eventCondition.notify_one();
+}
+
+void JsonSearchEventHandler::write(const JsonSearchEvent& event)
+{
+    const NodeCount nodesPerSecond = event.nodeCount * 1000 / std::max(event.time, std::time_t(1));
+
+    this->outputFile << "{\"event\":\"" << EventNames[static_cast<std::uint32_t>(event.type)] << "\"";
+
+    if (event.type == JsonSearchEventType::SEARCH) {
+        this->outputFile << ",\"fen\":\"" << event.fen << "\"";
+    }
+
+    this->outputFile << ",\"depth\":" << int(event.depth / Depth::ONE)
+        << ",\"seldepth\":" << int(event.selectiveDepth / Depth::ONE);
+
+    //Mates are given in moves, positive when we're the one mating
+    if (IsMateScore(event.score)) {
+        const std::int32_t plies = DistanceToWin(event.score);
+        const std::int32_t moves = (plies + 1) / 2;
+
+        this->outputFile << ",\"mate\":" << (IsWinScore(event.score) ? moves : -moves);
+    }
+    else {
+        this->outputFile << ",\"cp\":" << static_cast<int>(event.score / (PAWN_SCORE / 100.0f));
+    }
+
+    this->outputFile << ",\"nodes\":" << event.nodeCount
+        << ",\"nps\":" << nodesPerSecond
+        << ",\"time\":" << event.time;
+
+    if (event.type == JsonSearchEventType::DEPTH) {
+        this->outputFile << ",\"iterationtime\":" << event.iterationTime;
+    }
+
+    this->outputFile << ",\"hashfull\":" << event.hashfull;
+
+    std::stringstream ss;
+    event.principalVariation.printToStringStream(ss);
+
+    std::string principalVariation = ss.str();
+
+    while (!principalVariation.empty() && principalVariation.back() == ' ') {
+        principalVariation.pop_back();
+    }
+
+    this->outputFile << ",\"pv\":\"" << principalVariation << "\"}\n";
+}
+
+void JsonSearchEventHandler::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(this->eventMutex);
+
+    while (true) {
+        this->eventCondition.wait(lock, [this] { return this->isStopping || !this->eventQueue.empty(); });
+
+        //1) Take everything queued so far, and let the search keep queueing while it's written
+        std::deque<JsonSearchEvent> events;
+        events.swap(this->eventQueue);
+
+        const bool isStopping = this->isStopping;
+
+        lock.unlock();
+
+        //2) Write the events out
+        {
+            std::lock_guard<std::mutex> outputFileLock(this->outputFileMutex);
+
+            if (this->outputFile.is_open()) {
+                for (const JsonSearchEvent& event : events) {
+                    this->write(event);
+                }
+
+                this->outputFile.flush();
+            }
+        }
+
+        if (isStopping) {
+            break;
+        }
+
+        lock.lock();
+    }
+}
+
+void JsonSearchEventHandler::onLineCompleted(const ChessPrincipalVariation& principalVariation, std::time_t time, NodeCount nodeCount, Score score, Depth depth)
+{
+    this->push({
+        .type = JsonSearchEventType::LINE,
+        .principalVariation = principalVariation,
+        .time = time,
+        .iterationTime = time - this->lastDepthEvent.time,
+        .nodeCount = nodeCount,
+        .score = score,
+        .depth = depth,
+        .selectiveDepth = this->searcher.getSelectiveDepth(),
+        .hashfull = this->searcher.getHashfull(),
+        .fen = {}
+    });
+}
+
+void JsonSearchEventHandler::onDepthCompleted(const ChessPrincipalVariation& principalVariation, std::time_t time, NodeCount nodeCount, Score score, Depth depth)
+{
+    JsonSearchEvent event = {
+        .type = JsonSearchEventType::DEPTH,
+        .principalVariation = principalVariation,
+        .time = time,
+        .iterationTime = time - this->lastDepthEvent.time,
+        .nodeCount = nodeCount,
+        .score = score,
+        .depth = depth,
+        .selectiveDepth = this->searcher.getSelectiveDepth(),
+        .hashfull = this->searcher.getHashfull(),
+        .fen = {}
+    };
+
+    this->lastDepthEvent = event;
+
+    this->push(std::move(event));
+}
+
+void JsonSearchEventHandler::onSearchCompleted(const ChessBoard& board)
+{
+    //The search summary repeats the deepest completed depth, with the time the whole search took
+    JsonSearchEvent event = this->lastDepthEvent;
+
+    event.type = JsonSearchEventType::SEARCH;
+    event.time = this->searcher.getSearchTime();
+    event.nodeCount = this->searcher.getNodeCount();
+    event.hashfull = this->searcher.getHashfull();
+    event.fen = board.saveToFen();
+
+    this->lastDepthEvent = {};
+
+    this->push(std::move(event));
+}
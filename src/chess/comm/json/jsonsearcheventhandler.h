@@ -0,0 +1,89 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "../../../game/search/events/searcheventhandler.h"
+
+#include "../../board/board.h"
+#include "../../search/chesspv.h"
+#include "../../search/searcher.h"
+
+enum class JsonSearchEventType {
+    LINE,
+    DEPTH,
+    SEARCH
+};
+
+struct JsonSearchEvent
+{
+    JsonSearchEventType type;
+
+    ChessPrincipalVariation principalVariation;
+
+    std::time_t time;
+    std::time_t iterationTime;
+    NodeCount nodeCount;
+    Score score;
+    Depth depth;
+    Depth selectiveDepth;
+    std::uint32_t hashfull;
+
+    std::string fen;
+};
+
+//Writes one JSON object per line for each search event.  The search only queues the event, a writer thread formats
+//and writes it, so a slow file or pipe never holds up the search.
+class JsonSearchEventHandler : public SearchEventHandler<ChessBoard, ChessPrincipalVariation>
+{
+protected:
+    const ChessSearcher& searcher;
+
+    std::ofstream outputFile;
+    std::mutex outputFileMutex;
+
+    std::deque<JsonSearchEvent> eventQueue;
+    std::mutex eventMutex;
+    std::condition_variable eventCondition;
+
+    std::thread writerThread;
+    bool isStopping = false;
+
+    //Only touched by the search thread
+    JsonSearchEvent lastDepthEvent = {};
+
+    void push(JsonSearchEvent&& event);
+    void write(const JsonSearchEvent& event);
+    void writerLoop();
+public:
+    JsonSearchEventHandler(const ChessSearcher& searcher);
+    ~JsonSearchEventHandler();
+
+    bool open(const std::string& fileName);
+
+    void onLineCompleted(const ChessPrincipalVariation& principalVariation, std::time_t time, NodeCount nodeCount, Score score, Depth depth);
+    void onDepthCompleted(const ChessPrincipalVariation& principalVariation, std::time_t time, NodeCount nodeCount, Score score, Depth depth);
+    void onSearchCompleted(const ChessBoard& board);
+};
@@ -16,16 +16,31 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <chrono>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "xboard.h"
 
 #include "../board/movegenerator.h"
 
+#include "../book/bookbuilder.h"
+
 #include "../search/perft.h"
+#include "../search/statistics.h"
+#include "../selfplay/datagen.h"
+#include "../selfplay/match.h"
+#include "../selfplay/packedposition.h"
+
+#include "../tablebase/generator.h"
+#include "../tablebase/tablebase.h"
+#include "../tuning/tuner.h"
+
+#include "../../game/clock/profiler.h"
 
 #include "../../game/types/depth.h"
 #include "../../game/types/nodecount.h"
@@ -37,6 +52,84 @@ struct XBoardCommand {
     void (*function)(XBoardComm* xboard, std::stringstream& cmd);
 };
 
+static void xboardBuildBook(XBoardComm* xboard, std::stringstream& cmd)
+{
+    std::string bookFileName, argument;
+    cmd >> bookFileName;
+
+    if (bookFileName.empty()) {
+        std::cout << "Usage: buildbook <book> [plies] <pgn or position files>" << std::endl;
+        return;
+    }
+
+    std::uint32_t maxPlies = DefaultBookBuildPlies;
+    std::vector<std::string> inputFileNames;
+
+    while (cmd >> argument) {
+        if (inputFileNames.empty() && isdigit(argument[0])) {
+            maxPlies = std::stoi(argument);
+        }
+        else {
+            inputFileNames.push_back(argument);
+        }
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    ChessBookBuilder bookBuilder(bookFileName, maxPlies, DefaultBookBuildPositions);
+
+    //PGN files are read as games, anything else as lines of data/positions.txt
+    for (const std::string& inputFileName : inputFileNames) {
+        const bool isPgn = std::filesystem::path(inputFileName).extension() == ".pgn";
+        const bool success = isPgn ? bookBuilder.addPgnFile(inputFileName) : bookBuilder.addPositionFile(inputFileName);
+
+        if (!success) {
+            std::cout << "Unable to read " << inputFileName << std::endl;
+            return;
+        }
+    }
+
+    if (!bookBuilder.save()) {
+        std::cout << "Unable to save book " << bookFileName << std::endl;
+        return;
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+
+    std::cout << "Built " << bookFileName << " from " << bookBuilder.getGameCount() << " games (" << bookBuilder.getSkippedGameCount() << " skipped) in "
+        << elapsed.count() << " ms" << std::endl;
+}
+
+static void xboardDatagen(XBoardComm* xboard, std::stringstream& cmd)
+{
+    std::string fileName;
+    cmd >> fileName;
+
+    if (fileName.empty()) {
+        std::cout << "Usage: datagen <file> [games] [nodes] [threads]" << std::endl;
+        return;
+    }
+
+    DataGeneratorSettings settings;
+    std::uint32_t threadCount = 0;
+
+    cmd >> settings.gameCount >> settings.nodesPerMove >> threadCount;
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    ChessDataGenerator dataGenerator(settings, threadCount);
+
+    if (!dataGenerator.generate(fileName)) {
+        std::cout << "Unable to write " << fileName << std::endl;
+        return;
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+
+    std::cout << "Generated " << dataGenerator.getPositionCount() << " positions from " << settings.gameCount << " games in "
+        << elapsed.count() << " ms" << std::endl;
+}
+
 static void xboardEval(XBoardComm* xboard, std::stringstream& cmd)
 {
     const Score score = xboard->evaluateBoard();
@@ -74,6 +167,9 @@ static void xboardGo(XBoardComm* xboard, std::stringstream& cmd)
         saveOutOfBookFen(board.saveToFen());
     }
 
+    Clock& clock = xboard->getPlayerClock();
+    clock.onMoveRequested();
+
     xboard->getPlayerMove(playerMove);
 
     xboard->doPlayerMove(playerMove);
@@ -82,9 +178,27 @@ static void xboardGo(XBoardComm* xboard, std::stringstream& cmd)
     principalVariation.printMoveToConsole(playerMove);
     std::cout << std::endl;
 
+    clock.onMoveSent();
+
     xboard->setForce(false);
 }
 
+static void xboardJsonLog(XBoardComm* xboard, std::stringstream& cmd)
+{
+    //Search events go to the file as JSON lines, /dev/fd/N writes them to an inherited descriptor
+    std::string fileName;
+    cmd >> fileName;
+
+    if (fileName.empty()) {
+        std::cout << "Usage: jsonlog <file>" << std::endl;
+        return;
+    }
+
+    if (!xboard->openJsonLog(fileName)) {
+        std::cout << "Unable to open " << fileName << std::endl;
+    }
+}
+
 static void xboardLevel(XBoardComm* xboard, std::stringstream& cmd)
 {
     NodeCount moveCount = ZeroNodes;
@@ -125,9 +239,57 @@ static void xboardLevel(XBoardComm* xboard, std::stringstream& cmd)
     xboard->getPlayerClock().setClockLevel(moveCount, 1000 * seconds, 1000 * increment);
 }
 
+static void xboardMatch(XBoardComm* xboard, std::stringstream& cmd)
+{
+    std::string personalityFileNames[2], openingsFileName;
+    cmd >> personalityFileNames[0] >> personalityFileNames[1] >> openingsFileName;
+
+    if (openingsFileName.empty()) {
+        std::cout << "Usage: match <personality> <control personality or -> <epd openings> [nodes] [threads] [game pairs]" << std::endl;
+        return;
+    }
+
+    MatchSettings settings;
+    std::uint32_t threadCount = 0;
+
+    cmd >> settings.nodesPerMove >> threadCount >> settings.maxGamePairs;
+
+    ChessMatch match(settings, threadCount);
+
+    if (!match.loadOpenings(openingsFileName)) {
+        std::cout << "Unable to load openings from " << openingsFileName << std::endl;
+        return;
+    }
+
+    //Each engine gets the defaults with its personality applied, if it has one
+    for (std::uint32_t i = 0; i < 2; i++) {
+        const std::shared_ptr<EvalParameters> evalParameters = std::make_shared<EvalParameters>(DefaultEvalParameters);
+
+        if (personalityFileNames[i] != "-") {
+            Personality personality;
+            personality.loadPersonalityFile(personalityFileNames[i]);
+
+            evalParameters->applyPersonality(personality);
+        }
+
+        match.setEngine(i, { i == 0 ? "JingWeiExperimental" : "JingWeiControl", evalParameters });
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    const SprtResult result = match.play();
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+
+    std::cout << (result == SprtResult::SPRT_ACCEPT_H1 ? "H1 was accepted" : (result == SprtResult::SPRT_ACCEPT_H0 ? "H0 was accepted" : "SPRT was inconclusive"))
+        << " after " << match.getSprt().getGameCount() << " games in " << elapsed.count() << " ms" << std::endl;
+}
+
 static void xboardNew(XBoardComm* xboard, std::stringstream& cmd)
 {
     xboard->resetStartingPosition();
+
+    xboard->getPlayerClock().resetLatencyStatistics();
 }
 
 static void xboardNps(XBoardComm* xboard, std::stringstream& cmd)
@@ -146,6 +308,98 @@ static void xboardOtim(XBoardComm* xboard, std::stringstream& cmd)
     xboard->getPlayerClock().setClockOpponentTimeLeft(centiseconds * 10);
 }
 
+static void xboardOption(XBoardComm* xboard, std::stringstream& cmd)
+{
+    //Option names may contain spaces, so split on the '=' instead
+    std::string option = cmd.str();
+    option = option.substr(option.find_first_of(' ') + 1);
+
+    const std::size_t equals = option.find_first_of('=');
+
+    if (equals == std::string::npos) {
+        std::cout << "Unknown Option: " << option << std::endl;
+        return;
+    }
+
+    const std::string name = option.substr(0, equals);
+    std::stringstream value(option.substr(equals + 1));
+
+    if (name == "Book File") {
+        std::string bookFileName;
+        std::getline(value, bookFileName);
+
+        if (!bookFileName.empty() && !xboard->loadBookFile(bookFileName)) {
+            std::cout << "Unable to load book " << bookFileName << std::endl;
+        }
+    }
+    else if (name == "Book Depth") {
+        std::uint32_t bookDepth;
+        value >> bookDepth;
+
+        xboard->setBookDepth(bookDepth);
+    }
+    else if (name == "Polyglot Book") {
+        std::string bookFileName;
+        std::getline(value, bookFileName);
+
+        if (!bookFileName.empty() && !xboard->loadPolyglotBookFile(bookFileName)) {
+            std::cout << "Unable to load Polyglot book " << bookFileName << std::endl;
+        }
+    }
+    else if (name == "Move Overhead") {
+        std::time_t milliseconds;
+        value >> milliseconds;
+
+        xboard->getPlayerClock().setMoveOverhead(milliseconds);
+    }
+    else if (name == "Tablebase Path") {
+        std::string directory;
+        std::getline(value, directory);
+
+        ClearTablebases();
+
+        const std::uint32_t tablebaseCount = LoadTablebases(directory);
+
+        std::cout << "Loaded " << tablebaseCount << " tablebases" << std::endl;
+    }
+    else if (name == "Tablebase Probe Pieces") {
+        std::uint32_t pieceCount;
+        value >> pieceCount;
+
+        SetTablebaseProbePieceLimit(pieceCount);
+    }
+    else if (name == "Tablebase Probe Depth") {
+        //There's no operator to get a Depth from a std::stringstream
+        int depth;
+        value >> depth;
+
+        SetTablebaseProbeDepth(Depth::ONE * depth);
+    }
+    else {
+        std::cout << "Unknown Option: " << name << std::endl;
+    }
+}
+
+static void xboardPackPositions(XBoardComm* xboard, std::stringstream& cmd)
+{
+    std::string positionFileName, packedFileName;
+    cmd >> positionFileName >> packedFileName;
+
+    if (packedFileName.empty()) {
+        std::cout << "Usage: packpositions <position file> <packed file>" << std::endl;
+        return;
+    }
+
+    std::uint64_t positionCount;
+
+    if (!PackPositionFile(positionFileName, packedFileName, positionCount)) {
+        std::cout << "Unable to pack " << positionFileName << " into " << packedFileName << std::endl;
+        return;
+    }
+
+    std::cout << "Packed " << positionCount << " positions" << std::endl;
+}
+
 static void xboardPerft(XBoardComm* xboard, std::stringstream& cmd)
 {
     Clock clock;
@@ -205,6 +459,25 @@ static void xboardPositionDatabase(XBoardComm* xboard, std::stringstream& cmd)
     xboard->addSearchAnalyzer();
 }
 
+static void xboardProfile(XBoardComm* xboard, std::stringstream& cmd)
+{
+    //Where the cycles of every search since the last reset went; "profile reset" clears them
+    std::string action;
+    cmd >> action;
+
+    if (!enableCycleProfiler) {
+        std::cout << "The cycle profiler is not compiled in, build with CYCLE_PROFILER defined" << std::endl;
+        return;
+    }
+
+    if (action == "reset") {
+        ResetCycleProfile();
+        return;
+    }
+
+    GetCycleProfile().print();
+}
+
 static void xboardQuit(XBoardComm* xboard, std::stringstream& cmd)
 {
     xboard->finish();
@@ -224,6 +497,8 @@ static void xboardResult(XBoardComm* xboard, std::stringstream& cmd)
     else if (result == "1/2-1/2") {
         xboard->setResult(TwoPlayerGameResult::DRAW);
     }
+
+    xboard->getPlayerClock().printLatencySummary();
 }
 
 static void xboardSd(XBoardComm* xboard, std::stringstream& cmd)
@@ -268,6 +543,70 @@ static void xboardSt(XBoardComm* xboard, std::stringstream& cmd)
     xboard->getPlayerClock().setClockSearchTime(seconds * 1000);
 }
 
+static void xboardStats(XBoardComm* xboard, std::stringstream& cmd)
+{
+    //Totals of every search since the last reset; "stats reset" clears them
+    std::string action;
+    cmd >> action;
+
+    if (!enableSearchStatistics) {
+        std::cout << "Search statistics are not compiled in, build with SEARCH_STATISTICS defined" << std::endl;
+        return;
+    }
+
+    if (action == "reset") {
+        ResetSearchStatistics();
+        return;
+    }
+
+    GetSearchStatistics().print();
+}
+
+static void xboardTbGenerate(XBoardComm* xboard, std::stringstream& cmd)
+{
+    //A piece count generates every table up to that size, a name like KQvKR just that table and the ones it needs
+    std::string directory, target;
+    cmd >> directory >> target;
+
+    if (directory.empty()) {
+        directory = DefaultTablebaseDirectory;
+    }
+
+    if (target.empty()) {
+        target = "4";
+    }
+
+    TablebaseGenerator generator(directory);
+    TablebaseMaterial material;
+
+    bool success;
+
+    if (isdigit(target[0])) {
+        success = generator.generateAll(std::stoi(target));
+    }
+    else if (ParseTablebaseMaterial(target, material)) {
+        success = generator.generate(material);
+    }
+    else {
+        std::cout << "Unknown Tablebase: " << target << std::endl;
+        return;
+    }
+
+    std::cout << (success ? "Tablebases generated in " : "Tablebase generation failed in ") << directory << std::endl;
+}
+
+static void xboardTbPath(XBoardComm* xboard, std::stringstream& cmd)
+{
+    std::string directory;
+    cmd >> directory;
+
+    ClearTablebases();
+
+    const std::uint32_t tablebaseCount = LoadTablebases(directory.empty() ? DefaultTablebaseDirectory : directory);
+
+    std::cout << "Loaded " << tablebaseCount << " tablebases" << std::endl;
+}
+
 static void xboardTime(XBoardComm* xboard, std::stringstream& cmd)
 {
     std::time_t centiseconds;
@@ -276,11 +615,62 @@ static void xboardTime(XBoardComm* xboard, std::stringstream& cmd)
     xboard->getPlayerClock().setClockEngineTimeLeft(centiseconds * 10);
 }
 
+static void xboardTune(XBoardComm* xboard, std::stringstream& cmd)
+{
+    std::string packedFileName, personalityFileName;
+    cmd >> packedFileName >> personalityFileName;
+
+    if (personalityFileName.empty()) {
+        std::cout << "Usage: tune <packed file> <personality file> [epochs] [threads]" << std::endl;
+        return;
+    }
+
+    TunerSettings settings;
+    std::uint32_t threadCount = 0;
+
+    cmd >> settings.epochs >> threadCount;
+
+    ChessTuner tuner(settings, threadCount);
+
+    if (!tuner.loadPositions(packedFileName) || tuner.getPositionCount() == 0) {
+        std::cout << "Unable to load positions from " << packedFileName << std::endl;
+        return;
+    }
+
+    std::cout << "Tuning " << tuner.getParameterCount() << " parameters over " << tuner.getPositionCount() << " positions" << std::endl;
+
+    tuner.tune();
+
+    if (!tuner.savePersonality(personalityFileName)) {
+        std::cout << "Unable to save personality " << personalityFileName << std::endl;
+    }
+}
+
 static void xboardUndo(XBoardComm* xboard, std::stringstream& cmd)
 {
     xboard->undoPlayerMove();
 }
 
+static void xboardUnpackPositions(XBoardComm* xboard, std::stringstream& cmd)
+{
+    std::string packedFileName, positionFileName;
+    cmd >> packedFileName >> positionFileName;
+
+    if (positionFileName.empty()) {
+        std::cout << "Usage: unpackpositions <packed file> <position file>" << std::endl;
+        return;
+    }
+
+    std::uint64_t positionCount;
+
+    if (!UnpackPositionFile(packedFileName, positionFileName, positionCount)) {
+        std::cout << "Unable to unpack " << packedFileName << " into " << positionFileName << std::endl;
+        return;
+    }
+
+    std::cout << "Unpacked " << positionCount << " positions" << std::endl;
+}
+
 static void xboardUserMove(XBoardComm* xboard, std::stringstream& cmd)
 {
     std::string moveString;
@@ -303,25 +693,40 @@ static void xboardUserMove(XBoardComm* xboard, std::stringstream& cmd)
 
 static void xboardXboard(XBoardComm* xboard, std::stringstream& cmd)
 {
-    std::cout << "feature setboard=1 usermove=1 time=1 analyze=0 myname=\"Jing Wei\" name=1 nps=1 done=1\n";
+    std::cout << "feature setboard=1 usermove=1 time=1 analyze=0 myname=\"Jing Wei\" name=1 nps=1\n";
+    std::cout << "feature option=\"Book File -file \"\n";
+    std::cout << "feature option=\"Polyglot Book -file \"\n";
+    std::cout << "feature option=\"Book Depth -spin " << DefaultBookDepth << " 0 " << std::int32_t(Depth::MAX) << "\"\n";
+    std::cout << "feature option=\"Move Overhead -spin " << DefaultMoveOverhead << " 0 " << MaximumMoveOverhead << "\"\n";
+    std::cout << "feature option=\"Tablebase Path -path " << DefaultTablebaseDirectory << "\"\n";
+    std::cout << "feature option=\"Tablebase Probe Pieces -spin " << TablebaseMaxPieces << " 0 " << TablebaseMaxPieces << "\"\n";
+    std::cout << "feature option=\"Tablebase Probe Depth -spin 0 0 " << std::int32_t(Depth::MAX) << "\"\n";
+    std::cout << "feature done=1\n";
 
     xboardNew(xboard, cmd);
 }
 
 static const struct XBoardCommand XBoardCommandList[] =
 {
+    { "buildbook", xboardBuildBook },
+    { "datagen", xboardDatagen },
     { "eval", xboardEval},
     { "exit", xboardQuit },
     { "fen", xboardFen },
     { "force", xboardForce },
     { "go", xboardGo },
+    { "jsonlog", xboardJsonLog },
     { "level", xboardLevel },
+    { "match", xboardMatch },
     { "new", xboardNew },
     { "nps", xboardNps },
+    { "option", xboardOption },
     { "otim", xboardOtim },
+    { "packpositions", xboardPackPositions },
     { "perft", xboardPerft },
     { "personality", xboardPersonality },
     { "ping", xboardPing },
+    { "profile", xboardProfile },
     { "quit", xboardQuit },
     { "result", xboardResult },
     { "sd", xboardSd },
@@ -329,8 +734,13 @@ static const struct XBoardCommand XBoardCommandList[] =
     { "setvalue", xboardSetValue },
     { "sn", xboardSn },
     { "st", xboardSt },
+    { "stats", xboardStats },
+    { "tbgenerate", xboardTbGenerate },
+    { "tbpath", xboardTbPath },
     { "time", xboardTime },
+    { "tune", xboardTune },
     { "undo", xboardUndo },
+    { "unpackpositions", xboardUnpackPositions },
     { "usermove", xboardUserMove },
     { "xboard", xboardXboard }, 
 
@@ -402,6 +812,28 @@ bool XBoardComm::isForced() const
     return this->force;
 }
 
+bool XBoardComm::loadBookFile(const std::string& bookFileName)
+{
+    return this->player.loadBookFile(bookFileName);
+}
+
+bool XBoardComm::loadPolyglotBookFile(const std::string& bookFileName)
+{
+    return this->player.loadPolyglotBookFile(bookFileName);
+}
+
+bool XBoardComm::openJsonLog(const std::string& fileName)
+{
+    if (this->jsonSearchEventHandler == nullptr) {
+        this->jsonSearchEventHandler = std::make_shared<JsonSearchEventHandler>(this->player.getSearcher());
+
+        ChessPlayer::EventHandlerSharedPtr searchEventHandler = this->jsonSearchEventHandler;
+        this->player.addSearchEventHandler(searchEventHandler);
+    }
+
+    return this->jsonSearchEventHandler->open(fileName);
+}
+
 void XBoardComm::loadPersonalityFile(const std::string& personalityFileName)
 {
     std::fstream personalityFile;
@@ -469,6 +901,11 @@ void XBoardComm::resetStartingPosition()
     this->player.resetStartingPosition();
 }
 
+void XBoardComm::setBookDepth(std::uint32_t bookDepth)
+{
+    this->player.setBookDepth(bookDepth);
+}
+
 void XBoardComm::setForce(bool force)
 {
     this->force = force;
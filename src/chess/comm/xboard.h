@@ -19,6 +19,7 @@
 #pragma once
 
 #include <ctime>
+#include <memory>
 
 #include "../../game/comm/comm.h"
 
@@ -29,6 +30,8 @@
 #include "../../game/types/nodecount.h"
 #include "../../game/types/score.h"
 
+#include "json/jsonsearcheventhandler.h"
+
 #include "xboard/xboardsearchanalyzereventhandler.h"
 #include "xboard/xboardsearcheventhandler.h"
 
@@ -42,6 +45,8 @@ private:
 
     bool hasAddedSearchAnalyzer = false;
     XBoardSearchAnalyzerSearchEventHandler searchAnalyzerEventHandler;
+
+    std::shared_ptr<JsonSearchEventHandler> jsonSearchEventHandler;
 public:
 	XBoardComm();
     ~XBoardComm() {}
@@ -63,6 +68,9 @@ public:
 
 	bool isForced() const;
 
+	bool loadBookFile(const std::string& bookFileName);
+	bool loadPolyglotBookFile(const std::string& bookFileName);
+	bool openJsonLog(const std::string& fileName);
 	void loadPersonalityFile(const std::string& personalityFileName);
 
 	NodeCount perft(Depth depth);
@@ -72,6 +80,7 @@ public:
 	void resetSpecificPosition(std::string& fen);
 	void resetStartingPosition();
 
+	void setBookDepth(std::uint32_t bookDepth);
 	void setForce(bool force);
 	void setParameter(std::string& name, Score score);
     void setResult(TwoPlayerGameResult result);
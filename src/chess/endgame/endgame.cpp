@@ -25,6 +25,7 @@
 
 #include "endgame.h"
 #include "function.h"
+#include "kpk.h"
 
 #include "eval/kk.h"
 
@@ -331,6 +332,8 @@ static std::map<std::string, ChessEndgame::EndgameFunctionType> chessEndgameMap
 
 void InitializeEndgame(ChessEndgame& endgame)
 {
+    InitializeKpkBitbase();
+
     for (auto const& [key, val] : chessEndgameMap) {
         ChessBoard board;
 
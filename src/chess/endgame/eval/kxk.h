@@ -19,8 +19,27 @@
 #pragma once
 
 #include "../function.h"
+#include "../kpk.h"
 
-constexpr ChessEndgame::EndgameFunctionType kpk = weakKingDrawishEndgameFunction;
+inline bool kpkBitbaseEndgameFunction(const ChessBoard& board, Score& score)
+{
+    //1) Determine strong side
+    const Color strongSide = FindStrongSide(board);
+    const bool strongSideIsWhite = strongSide == Color::WHITE;
+
+    const Square strongKing = strongSideIsWhite ? board.whiteKingPosition() : board.blackKingPosition();
+    const Square weakKing = strongSideIsWhite ? board.blackKingPosition() : board.whiteKingPosition();
+    const Square pawn = BitScanForward<Square>(strongSideIsWhite ? board.whitePieces[PieceType::PAWN] : board.blackPieces[PieceType::PAWN]);
+
+    //2) The bitbase knows whether the pawn can be forced through
+    if (ProbeKpkBitbase(strongSide, board.sideToMove, strongKing, weakKing, pawn)) {
+        return pushPawnEndgameFunction(board, score);
+    }
+
+    return drawEndgameFunction(board, score);
+}
+
+constexpr ChessEndgame::EndgameFunctionType kpk = kpkBitbaseEndgameFunction;
 
 constexpr ChessEndgame::EndgameFunctionType knk = drawEndgameFunction;
 constexpr ChessEndgame::EndgameFunctionType kbk = drawEndgameFunction;
@@ -26,6 +26,7 @@
 
 #include "../../../game/math/bitreset.h"
 #include "../../../game/math/bitscan.h"
+#include "../../../game/math/popcount.h"
 
 #include "../../../game/types/score.h"
 
@@ -92,7 +93,7 @@ constexpr bool kbpk(const ChessBoard& board, Score& score)
     const File pawnFile = GetFile(pawnSrc);
 
     //3) If there's more than one pawn and they're on different files, this is a win.
-    if (std::popcount(strongPawns) > 1) {
+    if (PopCount(strongPawns) > 1) {
         const Bitboard fileBitboard = FileBitboard[pawnFile];
 
         if ((strongPawns & fileBitboard) != strongPawns) {
@@ -49,8 +49,6 @@ constexpr std::array<Score, Square::SQUARE_COUNT> GeneralMate =
 
 constexpr std::array<Score, 11> KingProximity = { 0, 0, 90, 80, 70, 60, 50, 40, 30, 20, 10 };
 
-extern ChessEvaluation PstParameters[PieceType::PIECETYPE_COUNT][Square::SQUARE_COUNT];
-
 constexpr bool drawEndgameFunction(const ChessBoard& board, Score& score)
 {
     score = DRAW_SCORE;
@@ -88,7 +86,7 @@ constexpr bool pushPawnEndgameFunction(const ChessBoard& board, Score& score)
     }
 
     //psts are relative to white.  If strong side is Black, we have to negate.
-    const Score pst = strongSideIsWhite ? PstParameters[PieceType::PAWN][src].eg : -PstParameters[PieceType::PAWN][src].eg;
+    const Score pst = strongSideIsWhite ? DefaultEvalParameters.pst[PieceType::PAWN][src].eg : -DefaultEvalParameters.pst[PieceType::PAWN][src].eg;
 
     //3) Put it all together for the strong side
     score = baseScore + pst;
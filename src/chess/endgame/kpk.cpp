@@ -0,0 +1,202 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <mutex>
+#include <vector>
+
+#include "kpk.h"
+
+#include "../../game/types/bitboard.h"
+
+#include "../bitboards/moves.h"
+
+#include "../types/bitboard.h"
+#include "../types/direction.h"
+#include "../types/piecetype.h"
+
+std::array<std::uint64_t, KpkPositionCount / 64> KpkBitbase;
+
+enum KpkResult : std::uint8_t {
+    KPK_INVALID = 0, KPK_UNKNOWN = 1, KPK_DRAW = 2, KPK_WIN = 4
+};
+
+static constexpr std::uint32_t KpkIndex(Color sideToMove, Square weakKing, Square strongKing, Square pawn)
+{
+    const std::uint32_t pawnIndex = (GetRank(pawn) - Rank::_7) * 4 + GetFile(pawn);
+
+    return ((std::uint32_t(sideToMove) * Square::SQUARE_COUNT + weakKing) * Square::SQUARE_COUNT + strongKing) * 24 + pawnIndex;
+}
+
+static KpkResult initialKpkResult(Color sideToMove, Square weakKing, Square strongKing, Square pawn)
+{
+    const Bitboard pawnAttacks = WhitePawnCaptures[pawn];
+
+    //1) Overlapping pieces, touching kings, or the weak king in check with the strong side to move
+    if (weakKing == strongKing
+        || weakKing == pawn
+        || strongKing == pawn
+        || (PieceMoves[PieceType::KING][strongKing] & weakKing) != EmptyBitboard
+        || (sideToMove == Color::WHITE && (pawnAttacks & weakKing) != EmptyBitboard)) {
+        return KPK_INVALID;
+    }
+
+    //2) The pawn promotes and the new queen can't be taken
+    if (sideToMove == Color::WHITE
+        && GetRank(pawn) == Rank::_7) {
+        const Square promotion = pawn + Direction::UP;
+
+        if (promotion != weakKing
+            && promotion != strongKing
+            && ((PieceMoves[PieceType::KING][weakKing] & promotion) == EmptyBitboard
+                || (PieceMoves[PieceType::KING][strongKing] & promotion) != EmptyBitboard)) {
+            return KPK_WIN;
+        }
+    }
+
+    if (sideToMove == Color::BLACK) {
+        //3) Stalemate
+        const Bitboard weakKingMoves = PieceMoves[PieceType::KING][weakKing] & ~(PieceMoves[PieceType::KING][strongKing] | pawnAttacks);
+
+        if (weakKingMoves == EmptyBitboard) {
+            return KPK_DRAW;
+        }
+
+        //4) The undefended pawn falls
+        if ((PieceMoves[PieceType::KING][weakKing] & pawn) != EmptyBitboard
+            && (PieceMoves[PieceType::KING][strongKing] & pawn) == EmptyBitboard) {
+            return KPK_DRAW;
+        }
+    }
+
+    return KPK_UNKNOWN;
+}
+
+static KpkResult classifyKpkPosition(const std::vector<KpkResult>& results, Color sideToMove, Square weakKing, Square strongKing, Square pawn)
+{
+    std::uint8_t result = KPK_INVALID;
+
+    if (sideToMove == Color::WHITE) {
+        //1) Strong king moves
+        for (const Square dst : SquareBitboardIterator(PieceMoves[PieceType::KING][strongKing])) {
+            result |= results[KpkIndex(Color::BLACK, weakKing, dst, pawn)];
+        }
+
+        //2) Pawn pushes short of promotion, which step 2 of the initial pass already covers
+        if (GetRank(pawn) != Rank::_7) {
+            const Square push = pawn + Direction::UP;
+            result |= results[KpkIndex(Color::BLACK, weakKing, strongKing, push)];
+
+            if (GetRank(pawn) == Rank::_2
+                && push != weakKing
+                && push != strongKing) {
+                result |= results[KpkIndex(Color::BLACK, weakKing, strongKing, push + Direction::UP)];
+            }
+        }
+
+        return (result & KPK_WIN) ? KPK_WIN : ((result & KPK_UNKNOWN) ? KPK_UNKNOWN : KPK_DRAW);
+    }
+    else {
+        for (const Square dst : SquareBitboardIterator(PieceMoves[PieceType::KING][weakKing])) {
+            result |= results[KpkIndex(Color::WHITE, dst, strongKing, pawn)];
+        }
+
+        return (result & KPK_DRAW) ? KPK_DRAW : ((result & KPK_UNKNOWN) ? KPK_UNKNOWN : KPK_WIN);
+    }
+}
+
+template <typename Function>
+static void forEachKpkPosition(Function function)
+{
+    for (Color sideToMove = Color::COLOR_START; sideToMove < Color::COLOR_COUNT; sideToMove++) {
+        for (Square weakKing = Square::FIRST_SQUARE; weakKing < Square::SQUARE_COUNT; weakKing++) {
+            for (Square strongKing = Square::FIRST_SQUARE; strongKing < Square::SQUARE_COUNT; strongKing++) {
+                for (Rank rank = Rank::_7; rank <= Rank::_2; rank++) {
+                    for (File file = File::_A; file <= File::_D; file++) {
+                        function(sideToMove, weakKing, strongKing, file * rank);
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void BuildKpkBitbase()
+{
+    std::vector<KpkResult> results(KpkPositionCount);
+
+    //1) Everything decided by the position itself
+    forEachKpkPosition([&](Color sideToMove, Square weakKing, Square strongKing, Square pawn) {
+        results[KpkIndex(sideToMove, weakKing, strongKing, pawn)] = initialKpkResult(sideToMove, weakKing, strongKing, pawn);
+    });
+
+    //2) Work backwards from those until no position changes
+    bool changed = true;
+
+    while (changed) {
+        changed = false;
+
+        forEachKpkPosition([&](Color sideToMove, Square weakKing, Square strongKing, Square pawn) {
+            KpkResult& result = results[KpkIndex(sideToMove, weakKing, strongKing, pawn)];
+
+            if (result == KPK_UNKNOWN) {
+                result = classifyKpkPosition(results, sideToMove, weakKing, strongKing, pawn);
+                changed = changed || result != KPK_UNKNOWN;
+            }
+        });
+    }
+
+    //3) Whatever is still unknown can't be forced, so only the wins are kept
+    KpkBitbase.fill(0);
+
+    for (std::uint32_t i = 0; i < KpkPositionCount; i++) {
+        if (results[i] == KPK_WIN) {
+            KpkBitbase[i / 64] |= std::uint64_t(1) << (i % 64);
+        }
+    }
+}
+
+void InitializeKpkBitbase()
+{
+    //Every evaluator asks for the bitbase, possibly from several threads at once
+    static std::once_flag kpkBitbaseInitialized;
+
+    std::call_once(kpkBitbaseInitialized, BuildKpkBitbase);
+}
+
+bool ProbeKpkBitbase(Color strongSide, Color sideToMove, Square strongKing, Square weakKing, Square pawn)
+{
+    //1) Make the strong side white, pushing up the board
+    if (strongSide == Color::BLACK) {
+        strongKing = FlipSquareOnHorizontalLine(strongKing);
+        weakKing = FlipSquareOnHorizontalLine(weakKing);
+        pawn = FlipSquareOnHorizontalLine(pawn);
+
+        sideToMove = ~sideToMove;
+    }
+
+    //2) And keep the pawn on the queen side
+    if (GetFile(pawn) > File::_D) {
+        strongKing = FlipSquareOnVerticalLine(strongKing);
+        weakKing = FlipSquareOnVerticalLine(weakKing);
+        pawn = FlipSquareOnVerticalLine(pawn);
+    }
+
+    const std::uint32_t index = KpkIndex(sideToMove, weakKing, strongKing, pawn);
+
+    return (KpkBitbase[index / 64] & (std::uint64_t(1) << (index % 64))) != 0;
+}
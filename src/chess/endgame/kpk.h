@@ -0,0 +1,36 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+
+#include <cstdint>
+
+#include "../../game/types/color.h"
+
+#include "../types/square.h"
+
+//Side to move, weak king, strong king and a pawn on files a-d, ranks 2-7, with the pawn's side as white
+constexpr std::uint32_t KpkPositionCount = std::uint32_t(Color::COLOR_COUNT) * Square::SQUARE_COUNT * Square::SQUARE_COUNT * 24;
+
+extern std::array<std::uint64_t, KpkPositionCount / 64> KpkBitbase;
+
+void InitializeKpkBitbase();
+
+bool ProbeKpkBitbase(Color strongSide, Color sideToMove, Square strongKing, Square weakKing, Square pawn);
@@ -16,6 +16,8 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <array>
+
 #include <cassert>
 
 #include "evaluator.h"
@@ -29,9 +31,13 @@
 
 #include "../endgame/function.h"
 
+#include "../tablebase/tablebase.h"
+
 #include "../types/bitboard.h"
 #include "../types/score.h"
 
+#include "../../game/clock/profiler.h"
+
 #include "../../game/math/bitreset.h"
 #include "../../game/math/bitscan.h"
 #include "../../game/math/byteswap.h"
@@ -39,24 +45,29 @@
 
 #include "../../game/search/hashtable.h"
 
-extern ChessEvaluation DoubledRooks;
 extern ChessEvaluation EmptyFileQueen;
-extern ChessEvaluation EmptyFileRook;
-extern ChessEvaluation Tempo;
-
-extern std::array<ChessEvaluation, 2> BishopPawns;
-extern std::array<ChessEvaluation, PieceType::PIECETYPE_COUNT> KingAttacks;
-extern std::array<ChessEvaluation, 2> KingShield;
-extern std::array<ChessEvaluation, PieceType::PIECETYPE_COUNT> Outpost;
-
-extern ChessEvaluation PiecePairs[PieceType::PIECETYPE_COUNT];
 
 extern ChessEvaluation QueenBehindPassedPawnPst[Square::SQUARE_COUNT];
 extern ChessEvaluation RookBehindPassedPawnPst[Square::SQUARE_COUNT];
 
-extern ChessEvaluation TropismParameters[PieceType::PIECETYPE_COUNT][16];
+//Euclidean distance rounded down, by file and rank distance
+static constexpr auto Distance = []() {
+    std::array<std::array<std::uint32_t, Rank::RANK_COUNT>, File::FILE_COUNT> result = {};
+
+    for (std::uint32_t file = 0; file < File::FILE_COUNT; file++) {
+        for (std::uint32_t rank = 0; rank < Rank::RANK_COUNT; rank++) {
+            std::uint32_t distance = 0;
 
-extern std::uint32_t Distance[File::FILE_COUNT][Rank::RANK_COUNT];
+            while ((distance + 1) * (distance + 1) <= file * file + rank * rank) {
+                distance++;
+            }
+
+            result[file][rank] = distance;
+        }
+    }
+
+    return result;
+}();
 
 constexpr std::uint32_t EVALUATION_HASH_MEGABYTES = 1;
 constexpr std::uint32_t PAWN_HASH_MEGABYTES = 1;
@@ -80,7 +91,8 @@ ChessEvaluator::ChessEvaluator()
     //}
 }
 
-Score ChessEvaluator::evaluateImplementation(const BoardType& board, Depth currentDepth, Score alpha, Score beta)
+template <bool Trace>
+Score ChessEvaluator::evaluateBoard(const BoardType& board, Depth currentDepth, Score alpha, Score beta, EvaluationTrace* trace)
 {
     assert(!this->attackGenerator.dispatchIsInCheck(board));
 
@@ -90,11 +102,29 @@ Score ChessEvaluator::evaluateImplementation(const BoardType& board, Depth curre
 
     const bool isWhiteToMove = board.isWhiteToMove();
 
+    if constexpr (Trace) {
+        trace->clear();
+
+        trace->phase = board.getPhase();
+        trace->sideToMoveMultiplier = isWhiteToMove ? 1 : -1;
+
+        //Until the evaluation is known to come from the terms
+        trace->isLinear = false;
+    }
+
     //1) Check for end game score
     if (board.getPhase() <= 9) {
         this->passedPawns[Color::WHITE] = this->calculatePassedPawns(board, Color::WHITE);
         this->passedPawns[Color::BLACK] = this->calculatePassedPawns(board, Color::BLACK);
 
+        //1a) Tablebases know the exact result, when search isn't already probing them
+        TablebaseWdl wdl;
+
+        if (ShouldProbeTablebase(board, Depth::ZERO)
+            && ProbeTablebaseWdl(board, wdl)) {
+            return GetTablebaseScore(wdl, currentDepth);
+        }
+
         Score endgameScore;
         const bool endgameFound = this->endgame.probe(board, endgameScore);
 
@@ -150,13 +180,32 @@ Score ChessEvaluator::evaluateImplementation(const BoardType& board, Depth curre
     //4) Continue, actually evaluating the board
     EvaluationType evaluation = board.materialEvaluation + board.pstEvaluation;
 
+    //4a) The board keeps material and piece square scores up to date, so the trace has to count them itself
+    if constexpr (Trace) {
+        trace->isLinear = true;
+
+        for (const Square src : SquareBitboardIterator(board.allPieces)) {
+            const PieceType pieceType = board.pieceAt(src);
+            const bool colorIsWhite = (board.whitePieces[PieceType::ALL] & OneShiftedBy(src)) != EmptyBitboard;
+
+            const std::int32_t multiplier = colorIsWhite ? 1 : -1;
+            const Square evaluatedSrc = colorIsWhite ? src : FlipSquareOnHorizontalLine(src);
+
+            if (pieceType != PieceType::KING) {
+                trace->add(this->evalParameters->material[pieceType], multiplier);
+            }
+
+            trace->add(this->evalParameters->pst[pieceType][evaluatedSrc], multiplier);
+        }
+    }
+
     //5) Evaluate Pawn Structure.  Since the Pawn Evaluator is another evaluator, it will return score with side to move
     //  This must be done first because other evaluation terms rely on pawn structure calculations.
-    evaluation += this->evaluatePawnStructure(board, this->passedPawns[Color::WHITE], this->passedPawns[Color::BLACK]);
+    evaluation += this->evaluatePawnStructure<Trace>(board, this->passedPawns[Color::WHITE], this->passedPawns[Color::BLACK], trace);
 
     //6) Loop through pieces
-    evaluation += this->evaluatePawnAttacks(board, Color::WHITE);
-    evaluation -= this->evaluatePawnAttacks(board, Color::BLACK);
+    evaluation += this->evaluatePawnAttacks<Trace>(board, Color::WHITE, trace);
+    evaluation -= this->evaluatePawnAttacks<Trace>(board, Color::BLACK, trace);
 
     const BitboardPair UnsafeSquares = {
         this->attackGenerator.unsafeSquares(Color::WHITE, board.blackPieces),
@@ -176,8 +225,10 @@ Score ChessEvaluator::evaluateImplementation(const BoardType& board, Depth curre
         const Bitboard otherKingMoves = PieceMoves[PieceType::KING][otherKingPosition] & ~otherPieces[PieceType::KING];
 
         for (PieceType pieceType = PieceType::KNIGHT; pieceType <= PieceType::QUEEN; pieceType++) {
-            if (std::popcount(colorPieces[pieceType]) > 1) {
-                evaluation += multiplier * PiecePairs[pieceType];
+            if (PopCount(colorPieces[pieceType]) > 1) {
+                evaluation += multiplier * this->evalParameters->piecePairs[pieceType];
+
+                TraceEvaluationTerm<Trace>(trace, this->evalParameters->piecePairs[pieceType], multiplier);
             }
         }
 
@@ -190,7 +241,9 @@ Score ChessEvaluator::evaluateImplementation(const BoardType& board, Depth curre
             const Bitboard pawnsDefendedBy = PawnDefends & colorPieces[PieceType::PAWN];
 
             if (pawnsDefendedBy != EmptyBitboard) {
-                evaluation += multiplier * Outpost[pieceType];
+                evaluation += multiplier * this->evalParameters->outpost[pieceType];
+
+                TraceEvaluationTerm<Trace>(trace, this->evalParameters->outpost[pieceType], multiplier);
             }
 
             Bitboard mobilityDstSquares = EmptyBitboard;
@@ -203,14 +256,18 @@ Score ChessEvaluator::evaluateImplementation(const BoardType& board, Depth curre
                 mobilityDstSquares = BishopMagic(src, board.allPieces);
 
                 const Bitboard colorSameBishopColorPawns = SquaresSameColorAs(colorPieces[PieceType::PAWN], src);
-                const std::uint32_t ourPawnsOnSameColor = std::popcount(colorSameBishopColorPawns);
+                const std::uint32_t ourPawnsOnSameColor = PopCount(colorSameBishopColorPawns);
 
-                evaluation += multiplier * std::popcount(ourPawnsOnSameColor) * BishopPawns[Color::CURRENT_COLOR];
+                evaluation += multiplier * PopCount(ourPawnsOnSameColor) * this->evalParameters->bishopPawns[Color::CURRENT_COLOR];
+
+                TraceEvaluationTerm<Trace>(trace, this->evalParameters->bishopPawns[Color::CURRENT_COLOR], multiplier * PopCount(ourPawnsOnSameColor));
 
                 const Bitboard otherOppositeBishopColorPawns = SquaresOppositeColorAs(otherPieces[PieceType::PAWN], src);
-                const std::uint32_t otherPawnsOnOppositeColor = std::popcount(otherOppositeBishopColorPawns);
+                const std::uint32_t otherPawnsOnOppositeColor = PopCount(otherOppositeBishopColorPawns);
+
+                evaluation += multiplier * PopCount(otherPawnsOnOppositeColor) * this->evalParameters->bishopPawns[Color::OTHER_COLOR];
 
-                evaluation += multiplier * std::popcount(otherPawnsOnOppositeColor) * BishopPawns[Color::OTHER_COLOR];
+                TraceEvaluationTerm<Trace>(trace, this->evalParameters->bishopPawns[Color::OTHER_COLOR], multiplier * PopCount(otherPawnsOnOppositeColor));
 
             } break;
             case PieceType::ROOK: {
@@ -219,14 +276,18 @@ Score ChessEvaluator::evaluateImplementation(const BoardType& board, Depth curre
                 const Bitboard colorRooks = colorPieces[PieceType::ROOK];
 
                 if ((colorRooks & mobilityDstSquares) != EmptyBitboard) {
-                    evaluation += multiplier * DoubledRooks;
+                    evaluation += multiplier * this->evalParameters->doubledRooks;
+
+                    TraceEvaluationTerm<Trace>(trace, this->evalParameters->doubledRooks, multiplier);
                 }
 
                 const File file = GetFile(src);
                 const Bitboard piecesInSameFile = board.allPieces & FileBitboard[file];
 
                 if (piecesInSameFile == OneShiftedBy(src)) {
-                    evaluation += multiplier * EmptyFileRook;
+                    evaluation += multiplier * this->evalParameters->emptyFileRook;
+
+                    TraceEvaluationTerm<Trace>(trace, this->evalParameters->emptyFileRook, multiplier);
                 }
             } break;
             case PieceType::QUEEN:
@@ -245,8 +306,11 @@ Score ChessEvaluator::evaluateImplementation(const BoardType& board, Depth curre
                     Bitboard evaluatedPawns = colorIsWhite ? colorPieces[PieceType::PAWN] : FlipBitboardOnVertical(colorPieces[PieceType::PAWN]);
                     evaluatedPawns <<= 8 * (Rank::_1 - rank + 1);
 
-                    evaluation += multiplier * std::popcount(evaluatedPawns & shield) * KingShield[0];
-                    evaluation += multiplier * std::popcount((evaluatedPawns + Direction::DOWN) & shield) * KingShield[1];
+                    evaluation += multiplier * PopCount(evaluatedPawns & shield) * this->evalParameters->kingShield[0];
+                    evaluation += multiplier * PopCount((evaluatedPawns + Direction::DOWN) & shield) * this->evalParameters->kingShield[1];
+
+                    TraceEvaluationTerm<Trace>(trace, this->evalParameters->kingShield[0], multiplier * PopCount(evaluatedPawns & shield));
+                    TraceEvaluationTerm<Trace>(trace, this->evalParameters->kingShield[1], multiplier * PopCount((evaluatedPawns + Direction::DOWN) & shield));
                 }
 
             }   break;
@@ -254,17 +318,21 @@ Score ChessEvaluator::evaluateImplementation(const BoardType& board, Depth curre
                 assert(0);
             }
 
-            const std::uint32_t mobility = std::popcount(mobilityDstSquares & ~allColorPieces & ~UnsafeSquares[color]);
-            evaluation += multiplier * MobilityParameters[pieceType][mobility];
+            const std::uint32_t mobility = PopCount(mobilityDstSquares & ~allColorPieces & ~UnsafeSquares[color]);
+            evaluation += multiplier * this->evalParameters->mobility[pieceType][mobility];
+
+            TraceEvaluationTerm<Trace>(trace, this->evalParameters->mobility[pieceType][mobility], multiplier);
 
             if (pieceType != PieceType::KING) {
                 const Bitboard kingAttacks = mobilityDstSquares & otherKingMoves & ~UnsafeSquares[color];
 
-                const std::uint32_t kingAttackCount = std::popcount(kingAttacks);
-                evaluation += multiplier * KingAttacks[pieceType] * kingAttackCount;
+                const std::uint32_t kingAttackCount = PopCount(kingAttacks);
+                evaluation += multiplier * this->evalParameters->kingAttacks[pieceType] * kingAttackCount;
 
-                evaluation += multiplier * this->evaluateAttacks(board, color, pieceType, mobilityDstSquares);
-                evaluation += multiplier * this->evaluateTropism(pieceType, src, otherKingPosition);
+                TraceEvaluationTerm<Trace>(trace, this->evalParameters->kingAttacks[pieceType], multiplier * kingAttackCount);
+
+                evaluation += multiplier * this->evaluateAttacks<Trace>(board, color, pieceType, mobilityDstSquares, trace);
+                evaluation += multiplier * this->evaluateTropism<Trace>(pieceType, src, otherKingPosition, multiplier, trace);
             }
         }
     }
@@ -274,21 +342,44 @@ Score ChessEvaluator::evaluateImplementation(const BoardType& board, Depth curre
     }
 
     //7) Begin Result Calculation
-    const Score result = (isWhiteToMove ? evaluation(phase) : -evaluation(phase)) + Tempo(phase);
+    const Score result = (isWhiteToMove ? evaluation(phase) : -evaluation(phase)) + this->evalParameters->tempo(phase);
+
+    if constexpr (Trace) {
+        //Tempo goes to the side to move, and the trace is counted for white
+        trace->add(this->evalParameters->tempo, trace->sideToMoveMultiplier);
+        trace->compact();
+    }
 
     return result;
 }
 
-ChessEvaluation ChessEvaluator::evaluateTropism(PieceType pieceType, Square src, Square otherKingPosition) const
+Score ChessEvaluator::evaluateImplementation(const BoardType& board, Depth currentDepth, Score alpha, Score beta)
+{
+    const ScopedCycleProfile cycleProfile(ProfilePhase::EVALUATION);
+
+    return this->evaluateBoard<false>(board, currentDepth, alpha, beta, nullptr);
+}
+
+Score ChessEvaluator::traceEvaluation(const BoardType& board, EvaluationTrace& trace)
+{
+    trace.parameters = this->evalParameters;
+
+    return this->evaluateBoard<true>(board, Depth::ZERO, -WIN_SCORE, WIN_SCORE, &trace);
+}
+
+template <bool Trace>
+ChessEvaluation ChessEvaluator::evaluateTropism(PieceType pieceType, Square src, Square otherKingPosition, std::int32_t multiplier, EvaluationTrace* trace) const
 {
     const std::uint32_t tropism = Distance[FileDistance(otherKingPosition, src)][RankDistance(otherKingPosition, src)];
 
-    return TropismParameters[pieceType][tropism];
+    TraceEvaluationTerm<Trace>(trace, this->evalParameters->tropism[pieceType][tropism], multiplier);
+
+    return this->evalParameters->tropism[pieceType][tropism];
 }
 
 Score ChessEvaluator::lazyEvaluateImplementation(const BoardType& board)
 {
-    const EvaluationType evaluation = board.materialEvaluation + board.pstEvaluation + Tempo;
+    const EvaluationType evaluation = board.materialEvaluation + board.pstEvaluation + this->evalParameters->tempo;
 
     const std::int32_t phase = board.getPhase();
     const Score result = evaluation(phase);
@@ -29,32 +29,19 @@
 #include "../../game/eval/evaluator.h"
 
 #include "../../game/math/byteswap.h"
+#include "../../game/math/popcount.h"
 
 #include "../hash/chesshashtable.h"
 
 #include "constructor.h"
-
-extern ChessEvaluation PassedPawnDefended;
-extern std::array<ChessEvaluation, PieceType::PIECETYPE_COUNT> PassedPawnBlockedByPiece;
-
-extern ChessEvaluation AttackParameters[PieceType::PIECETYPE_COUNT][PieceType::PIECETYPE_COUNT];
-extern ChessEvaluation MobilityParameters[PieceType::PIECETYPE_COUNT][32];
+#include "parameters.h"
+#include "trace.h"
 
 extern ChessEvaluation PawnBlockedPstParameters[Color::COLOR_COUNT][Square::SQUARE_COUNT];
 
 //extern ChessEvaluation PawnChainBackByRank[Rank::RANK_COUNT];
 //extern ChessEvaluation PawnChainFrontByRank[Rank::RANK_COUNT];
 
-extern ChessEvaluation PawnChainBack;
-extern ChessEvaluation PawnChainFront;
-
-extern ChessEvaluation PawnChainBackPerRank;
-extern ChessEvaluation PawnChainFrontPerRank;
-
-extern ChessEvaluation PawnDoubledByRank[Rank::RANK_COUNT];
-extern ChessEvaluation PawnPassedByRank[Rank::RANK_COUNT];
-extern ChessEvaluation PawnPhalanxByRank[Rank::RANK_COUNT];
-
 class ChessEvaluator : public Evaluator<ChessEvaluator, ChessBoard, ChessEvaluation>
 {
 protected:
@@ -62,6 +49,8 @@ protected:
 
     ChessAttackGenerator attackGenerator;
 
+    const EvalParameters* evalParameters = &DefaultEvalParameters;
+
     Bitboard passedPawns[Color::COLOR_COUNT]{ EmptyBitboard, EmptyBitboard };
 
     constexpr void calculatePassedPawns(const BoardType& board, Bitboard& whitePassedPawns, Bitboard& blackPassedPawns) const
@@ -70,7 +59,8 @@ protected:
         blackPassedPawns = this->calculatePassedPawns(board, Color::BLACK);
     }
 
-    constexpr EvaluationType evaluateAttacks(const BoardType& board, Color color, PieceType srcPiece, Bitboard mobilityDstSquares) const
+    template <bool Trace>
+    constexpr EvaluationType evaluateAttacks(const BoardType& board, Color color, PieceType srcPiece, Bitboard mobilityDstSquares, EvaluationTrace* trace) const
     {
         EvaluationType result = { ZERO_SCORE, ZERO_SCORE };
 
@@ -85,13 +75,16 @@ protected:
             assert(attackedPiece != PieceType::KING);
 
             //TODO: Account for side to move
-            result += AttackParameters[srcPiece][attackedPiece];
+            result += this->evalParameters->attacks[srcPiece][attackedPiece];
+
+            TraceEvaluationTerm<Trace>(trace, this->evalParameters->attacks[srcPiece][attackedPiece], colorIsWhite ? 1 : -1);
         }
 
         return result;
     }
 
-    constexpr ChessEvaluation evaluatePawnAttacks(const BoardType& board, Color color) const
+    template <bool Trace>
+    constexpr ChessEvaluation evaluatePawnAttacks(const BoardType& board, Color color, EvaluationTrace* trace) const
     {
         EvaluationType result = { ZERO_SCORE, ZERO_SCORE };
 
@@ -104,15 +97,22 @@ protected:
 
         for (const Square dst : SquareBitboardIterator(allPawnAttacks)) {
             const PieceType attackedPiece = board.pieces[dst];
-            result += AttackParameters[PieceType::PAWN][attackedPiece];
+            result += this->evalParameters->attacks[PieceType::PAWN][attackedPiece];
+
+            TraceEvaluationTerm<Trace>(trace, this->evalParameters->attacks[PieceType::PAWN][attackedPiece], colorIsWhite ? 1 : -1);
         }
 
         return result;
     }
 
-    ChessEvaluation evaluateTropism(PieceType pieceType, Square src, Square otherKingPosition) const;
+    template <bool Trace>
+    Score evaluateBoard(const BoardType& board, Depth currentDepth, Score alpha, Score beta, EvaluationTrace* trace);
+
+    template <bool Trace>
+    ChessEvaluation evaluateTropism(PieceType pieceType, Square src, Square otherKingPosition, std::int32_t multiplier, EvaluationTrace* trace) const;
 
-    constexpr ChessEvaluation evaluatePawnStructure(const BoardType& board, Bitboard& whitePassedPawns, Bitboard& blackPassedPawns) const
+    template <bool Trace>
+    constexpr ChessEvaluation evaluatePawnStructure(const BoardType& board, Bitboard& whitePassedPawns, Bitboard& blackPassedPawns, EvaluationTrace* trace) const
     {
         //if (enablePawnHashtable) {
         //    HashtableEntryInfo hashtableEntryInfo;
@@ -157,12 +157,18 @@ protected:
                 //1) Check for a chained pawn
                 if (isDefendedByPawn) {
                     //result += multiplier * PawnChainFrontPstParameters[evaluatedSrc];
-                    result += multiplier * (PawnChainFront + ~evaluatedRank * PawnChainFrontPerRank);
+                    result += multiplier * (this->evalParameters->pawnChainFront + ~evaluatedRank * this->evalParameters->pawnChainFrontPerRank);
+
+                    TraceEvaluationTerm<Trace>(trace, this->evalParameters->pawnChainFront, multiplier);
+                    TraceEvaluationTerm<Trace>(trace, this->evalParameters->pawnChainFrontPerRank, multiplier * ~evaluatedRank);
 
                     for (const Square dst : SquareBitboardIterator(pawnsDefendedBy)) {
                         const Square evaluatedDst = colorIsWhite ? dst : FlipSquareOnHorizontalLine(dst);
                         //result += multiplier * PawnChainBackPstParameters[evaluatedDst];
-                        result += multiplier * (PawnChainBack + ~evaluatedRank * PawnChainBackPerRank);
+                        result += multiplier * (this->evalParameters->pawnChainBack + ~evaluatedRank * this->evalParameters->pawnChainBackPerRank);
+
+                        TraceEvaluationTerm<Trace>(trace, this->evalParameters->pawnChainBack, multiplier);
+                        TraceEvaluationTerm<Trace>(trace, this->evalParameters->pawnChainBackPerRank, multiplier * ~evaluatedRank);
                     }
                 }
 
@@ -170,7 +176,9 @@ protected:
                 const File file = GetFile(src);
                 if (file != File::_H
                     && (OneShiftedBy(src + Direction::RIGHT) & colorPawns) != EmptyBitboard) {
-                    result += multiplier * PawnPhalanxByRank[evaluatedRank];
+                    result += multiplier * this->evalParameters->pawnPhalanxByRank[evaluatedRank];
+
+                    TraceEvaluationTerm<Trace>(trace, this->evalParameters->pawnPhalanxByRank[evaluatedRank], multiplier);
                 }
 
                 //3) Check for a blocked pawn
@@ -188,12 +196,14 @@ protected:
                 const bool doubled = pawnsInFrontOfSrc != EmptyBitboard;
                 if (doubled) {
                     if (PopCountIsOne(pawnsInFrontOfSrc)) {
-                        result += multiplier * PawnDoubledByRank[evaluatedRank];
+                        result += multiplier * this->evalParameters->pawnDoubledByRank[evaluatedRank];
                     }
                     else {
-                        result += multiplier * PawnDoubledByRank[evaluatedRank];
+                        result += multiplier * this->evalParameters->pawnDoubledByRank[evaluatedRank];
                         //result += multiplier * PawnTripledByRank[evaluatedRank];
                     }
+
+                    TraceEvaluationTerm<Trace>(trace, this->evalParameters->pawnDoubledByRank[evaluatedRank], multiplier);
                 }
 
                 //5) Check for a passed pawn
@@ -201,10 +211,14 @@ protected:
                 if (passed) {
                     passedPawns |= src;
 
-                    result += multiplier * PawnPassedByRank[evaluatedRank];
+                    result += multiplier * this->evalParameters->pawnPassedByRank[evaluatedRank];
+
+                    TraceEvaluationTerm<Trace>(trace, this->evalParameters->pawnPassedByRank[evaluatedRank], multiplier);
 
                     if (isDefendedByPawn) {
-                        result += multiplier * PassedPawnDefended;
+                        result += multiplier * this->evalParameters->passedPawnDefended;
+
+                        TraceEvaluationTerm<Trace>(trace, this->evalParameters->passedPawnDefended, multiplier);
                     }
 
                     //const Direction forward = colorIsWhite ? Direction::UP : Direction::DOWN;
@@ -287,11 +301,11 @@ public:
             }
             break;
         case 4:
-            if (std::popcount(board.whitePieces[PieceType::KNIGHT]) == 2) {
+            if (PopCount(board.whitePieces[PieceType::KNIGHT]) == 2) {
                 return true;
             }
 
-            if (std::popcount(board.blackPieces[PieceType::KNIGHT]) == 2) {
+            if (PopCount(board.blackPieces[PieceType::KNIGHT]) == 2) {
                 return true;
             }
 
@@ -314,11 +328,25 @@ public:
 
 	Score evaluateImplementation(const BoardType& board, Depth currentDepth, Score alpha, Score beta);
 
+    //Evaluates with a full window, recording every evaluation term used
+    Score traceEvaluation(const BoardType& board, EvaluationTrace& trace);
+
     constexpr Bitboard getPassedPawnsForColor(Color color) const
     {
         return this->passedPawns[color];
     }
 
+    constexpr const EvalParameters& getEvalParameters() const
+    {
+        return *this->evalParameters;
+    }
+
+    //The parameters have to outlive the evaluator
+    constexpr void setEvalParameters(const EvalParameters* evalParameters)
+    {
+        this->evalParameters = evalParameters;
+    }
+
 	Score lazyEvaluateImplementation(const BoardType& board);
 
     void prefetch(Hash hashValue) const;
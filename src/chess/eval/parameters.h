@@ -18,4 +18,94 @@
 
 #pragma once
 
-void InitializeParameters();
+#include <array>
+
+#include "../../game/personality/parametermap.h"
+#include "../../game/personality/personality.h"
+
+#include "../types/file.h"
+#include "../types/piecetype.h"
+#include "../types/rank.h"
+#include "../types/score.h"
+#include "../types/square.h"
+
+#include "constructor.h"
+
+//Everything the evaluation and the incremental material and piece square scores read. Searchers, evaluators and board movers point
+//at one of these, so players with different personalities, or a tuner, can each have their own without touching anyone else's.
+struct EvalParameters {
+    ChessEvaluation material[PieceType::PIECETYPE_COUNT];
+    ChessEvaluation piecePairs[PieceType::PIECETYPE_COUNT];
+
+    ChessEvaluation doubledRooks;
+    ChessEvaluation emptyFileRook;
+
+    ChessEvaluation passedPawnDefended;
+
+    std::array<ChessEvaluation, 2> bishopPawns;
+    std::array<ChessEvaluation, PieceType::PIECETYPE_COUNT> kingAttacks;
+    std::array<ChessEvaluation, 2> kingShield;
+    std::array<ChessEvaluation, PieceType::PIECETYPE_COUNT> outpost;
+    std::array<ChessEvaluation, PieceType::PIECETYPE_COUNT> passedPawnBlockedByPiece;
+
+    ChessEvaluation tempo;
+
+    ChessEvaluation attacks[PieceType::PIECETYPE_COUNT][PieceType::PIECETYPE_COUNT];
+
+    ChessEvaluation pawnChainBack;
+    ChessEvaluation pawnChainFront;
+
+    ChessEvaluation pawnChainBackPerRank;
+    ChessEvaluation pawnChainFrontPerRank;
+
+    ChessEvaluation pawnDoubledByRank[Rank::RANK_COUNT];
+    ChessEvaluation pawnPassedByRank[Rank::RANK_COUNT];
+    ChessEvaluation pawnPhalanxByRank[Rank::RANK_COUNT];
+
+    ChessEvaluation pstByPieceAndFile[PieceType::PIECETYPE_COUNT][File::FILE_COUNT];
+    ChessEvaluation pstByPieceAndRank[PieceType::PIECETYPE_COUNT][Rank::RANK_COUNT];
+
+    ChessEvaluation pawnPst[Square::SQUARE_COUNT];
+
+    QuadraticParameterConstructorSet mobilityConstructorSet[PieceType::PIECETYPE_COUNT];
+    QuadraticParameterConstructorSet tropismConstructorSet[PieceType::PIECETYPE_COUNT];
+
+    //Built from the parameters above
+    ChessEvaluation pst[PieceType::PIECETYPE_COUNT][Square::SQUARE_COUNT];
+    ChessEvaluation mobility[PieceType::PIECETYPE_COUNT][32];
+    ChessEvaluation tropism[PieceType::PIECETYPE_COUNT][16];
+
+    //Has to be called after changing any of the parameters the tables are built from
+    void build()
+    {
+        const ScoreConstructor scoreConstructor;
+
+        for (PieceType pieceType = PieceType::PAWN; pieceType < PieceType::PIECETYPE_COUNT; pieceType++) {
+            scoreConstructor.construct(&(this->mobility[pieceType][0]), this->mobilityConstructorSet[pieceType], 32);
+            scoreConstructor.construct(&(this->tropism[pieceType][0]), this->tropismConstructorSet[pieceType], 16);
+        }
+
+        for (const Square src : SquareIterator()) {
+            File file = GetFile(src);
+            const Rank rank = GetRank(src);
+
+            if (file > File::_D) {
+                file = ~file;
+            }
+
+            this->pst[PieceType::PAWN][src] = this->pawnPst[src] + this->pstByPieceAndRank[PieceType::PAWN][rank] + this->pstByPieceAndFile[PieceType::PAWN][file];
+
+            for (PieceType pieceType = PieceType::KNIGHT; pieceType <= PieceType::KING; pieceType++) {
+                this->pst[pieceType][src] = this->pstByPieceAndRank[pieceType][rank] + this->pstByPieceAndFile[pieceType][file];
+            }
+        }
+    }
+
+    //Adds a personality's changes to the parameters it names, ignoring the search ones, and rebuilds the tables
+    void applyPersonality(Personality& personality);
+
+    //Names each tunable parameter the way personality files do, pointing into this instance
+    ParameterMap getParameterMap();
+};
+
+extern const EvalParameters DefaultEvalParameters;
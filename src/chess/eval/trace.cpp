@@ -0,0 +1,148 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <array>
+
+#include <cassert>
+#include <cstddef>
+
+#include "parameters.h"
+#include "trace.h"
+
+#include "../types/piecetype.h"
+#include "../types/rank.h"
+#include "../types/square.h"
+
+struct EvaluationTable {
+    std::size_t offset;
+    EvaluationTermIndex size;
+};
+
+//Every table the evaluator reads, material and piece square tables included
+static const EvaluationTable EvaluationTables[] = {
+    { offsetof(EvalParameters, material), PieceType::PIECETYPE_COUNT },
+    { offsetof(EvalParameters, pst), std::int32_t(PieceType::PIECETYPE_COUNT) * Square::SQUARE_COUNT },
+    { offsetof(EvalParameters, attacks), PieceType::PIECETYPE_COUNT * PieceType::PIECETYPE_COUNT },
+    { offsetof(EvalParameters, mobility), PieceType::PIECETYPE_COUNT * 32 },
+    { offsetof(EvalParameters, tropism), PieceType::PIECETYPE_COUNT * 16 },
+    { offsetof(EvalParameters, passedPawnDefended), 1 },
+    { offsetof(EvalParameters, pawnChainBack), 1 },
+    { offsetof(EvalParameters, pawnChainFront), 1 },
+    { offsetof(EvalParameters, pawnChainBackPerRank), 1 },
+    { offsetof(EvalParameters, pawnChainFrontPerRank), 1 },
+    { offsetof(EvalParameters, pawnDoubledByRank), Rank::RANK_COUNT },
+    { offsetof(EvalParameters, pawnPassedByRank), Rank::RANK_COUNT },
+    { offsetof(EvalParameters, pawnPhalanxByRank), Rank::RANK_COUNT },
+    { offsetof(EvalParameters, doubledRooks), 1 },
+    { offsetof(EvalParameters, emptyFileRook), 1 },
+    { offsetof(EvalParameters, tempo), 1 },
+    { offsetof(EvalParameters, bishopPawns), 2 },
+    { offsetof(EvalParameters, kingAttacks), PieceType::PIECETYPE_COUNT },
+    { offsetof(EvalParameters, kingShield), 2 },
+    { offsetof(EvalParameters, outpost), PieceType::PIECETYPE_COUNT },
+    { offsetof(EvalParameters, piecePairs), PieceType::PIECETYPE_COUNT },
+};
+
+static const ChessEvaluation* GetEvaluationTable(const EvalParameters& parameters, const EvaluationTable& table)
+{
+    return reinterpret_cast<const ChessEvaluation*>(reinterpret_cast<const char*>(&parameters) + table.offset);
+}
+
+static EvaluationTermIndex FindEvaluationTerm(const EvalParameters& parameters, const ChessEvaluation& term)
+{
+    EvaluationTermIndex offset = 0;
+
+    for (const EvaluationTable& table : EvaluationTables) {
+        const ChessEvaluation* terms = GetEvaluationTable(parameters, table);
+
+        if (&term >= terms && &term < terms + table.size) {
+            return offset + EvaluationTermIndex(&term - terms);
+        }
+
+        offset += table.size;
+    }
+
+    assert(0);
+
+    return offset;
+}
+
+void EvaluationTrace::add(const ChessEvaluation& term, std::int32_t coefficient)
+{
+    if (coefficient != 0) {
+        this->entries.push_back({ FindEvaluationTerm(*this->parameters, term), static_cast<std::int16_t>(coefficient) });
+    }
+}
+
+void EvaluationTrace::clear()
+{
+    this->entries.clear();
+
+    this->phase = 0;
+    this->sideToMoveMultiplier = 1;
+    this->isLinear = true;
+}
+
+void EvaluationTrace::compact()
+{
+    std::sort(this->entries.begin(), this->entries.end(),
+        [](const EvaluationTraceEntry& e1, const EvaluationTraceEntry& e2) { return e1.term < e2.term; });
+
+    std::size_t count = 0;
+
+    for (const EvaluationTraceEntry& entry : this->entries) {
+        if (count > 0 && this->entries[count - 1].term == entry.term) {
+            this->entries[count - 1].coefficient += entry.coefficient;
+        }
+        else {
+            this->entries[count++] = entry;
+        }
+    }
+
+    this->entries.resize(count);
+
+    this->entries.erase(std::remove_if(this->entries.begin(), this->entries.end(),
+        [](const EvaluationTraceEntry& entry) { return entry.coefficient == 0; }), this->entries.end());
+}
+
+EvaluationTermIndex GetEvaluationTermCount()
+{
+    EvaluationTermIndex result = 0;
+
+    for (const EvaluationTable& table : EvaluationTables) {
+        result += table.size;
+    }
+
+    return result;
+}
+
+const ChessEvaluation& GetEvaluationTerm(const EvalParameters& parameters, EvaluationTermIndex index)
+{
+    for (const EvaluationTable& table : EvaluationTables) {
+        if (index < table.size) {
+            return GetEvaluationTable(parameters, table)[index];
+        }
+
+        index -= table.size;
+    }
+
+    assert(0);
+
+    return parameters.tempo;
+}
@@ -0,0 +1,69 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include <cstdint>
+
+#include "../types/score.h"
+
+struct EvalParameters;
+
+using EvaluationTermIndex = std::uint16_t;
+
+struct EvaluationTraceEntry {
+    EvaluationTermIndex term;
+    std::int16_t coefficient;
+};
+
+//A position's evaluation as the number of times each evaluation table entry was counted for white, so it can be recalculated for any
+//parameters without the board: side to move * sum(coefficient * term(phase))
+class EvaluationTrace
+{
+public:
+    std::vector<EvaluationTraceEntry> entries;
+
+    //The terms are numbered by where they sit in the parameters being traced
+    const EvalParameters* parameters = nullptr;
+
+    std::int32_t phase = 0;
+    std::int32_t sideToMoveMultiplier = 1;
+
+    //Endgame knowledge and tablebases don't depend on the parameters
+    bool isLinear = true;
+
+    void add(const ChessEvaluation& term, std::int32_t coefficient);
+    void clear();
+
+    //Merges the entries for the same term and drops the ones that cancelled out
+    void compact();
+};
+
+//Every evaluation table entry the trace can refer to, in a fixed order
+EvaluationTermIndex GetEvaluationTermCount();
+const ChessEvaluation& GetEvaluationTerm(const EvalParameters& parameters, EvaluationTermIndex index);
+
+template <bool Trace>
+inline void TraceEvaluationTerm(EvaluationTrace* trace, const ChessEvaluation& term, std::int32_t coefficient)
+{
+    if constexpr (Trace) {
+        trace->add(term, coefficient);
+    }
+}
@@ -0,0 +1,84 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <mutex>
+#include <utility>
+
+#include <cassert>
+
+#include "cuckoo.h"
+#include "hash.h"
+
+#include "../bitboards/moves.h"
+
+#include "../../game/types/color.h"
+
+#include "../types/piecetype.h"
+
+std::array<Hash, CuckooTableSize> CuckooHashList;
+std::array<CuckooMove, CuckooTableSize> CuckooMoveList;
+
+static void BuildCuckooTables()
+{
+    CuckooHashList.fill(EmptyHash);
+    CuckooMoveList.fill(CuckooMove{ Square::A8, Square::A8 });
+
+    std::uint32_t count = 0;
+
+    //1) Every move of a non-pawn piece between two squares, in one direction only, as it would look on an empty board
+    for (Color color = Color::COLOR_START; color < Color::COLOR_COUNT; color++) {
+        for (PieceType piece = PieceType::KNIGHT; piece < PieceType::ALL; piece++) {
+            for (Square src = Square::FIRST_SQUARE; src < Square::SQUARE_COUNT; src++) {
+                for (Square dst = Square(src + 1); dst < Square::SQUARE_COUNT; dst++) {
+                    if ((PieceMoves[piece][src] & OneShiftedBy(dst)) == EmptyBitboard) {
+                        continue;
+                    }
+
+                    //2) Insert, evicting whatever sits in the slot to its other home until everything settles
+                    CuckooMove move{ src, dst };
+                    Hash moveHash = PieceHash(color, piece, src) ^ PieceHash(color, piece, dst) ^ WhiteToMoveHash;
+
+                    std::uint32_t index = CuckooHash1(moveHash);
+
+                    while (true) {
+                        std::swap(CuckooHashList[index], moveHash);
+                        std::swap(CuckooMoveList[index], move);
+
+                        if (moveHash == EmptyHash) {
+                            break;
+                        }
+
+                        index = (index == CuckooHash1(moveHash)) ? CuckooHash2(moveHash) : CuckooHash1(moveHash);
+                    }
+
+                    count++;
+                }
+            }
+        }
+    }
+
+    assert(count == 3668);
+}
+
+void InitializeCuckoo()
+{
+    //Every searcher asks for the tables, possibly from several threads at once, but they only need building once
+    static std::once_flag cuckooInitialized;
+
+    std::call_once(cuckooInitialized, BuildCuckooTables);
+}
@@ -0,0 +1,68 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+
+#include <cstdint>
+
+#include "../../game/types/hash.h"
+
+#include "../types/square.h"
+
+//Cuckoo tables of every reversible piece move, keyed by the hash difference the move makes,
+//used to spot a position one move away from repeating
+constexpr std::uint32_t CuckooTableSize = 8192;
+
+struct CuckooMove {
+    Square src;
+    Square dst;
+};
+
+extern std::array<Hash, CuckooTableSize> CuckooHashList;
+extern std::array<CuckooMove, CuckooTableSize> CuckooMoveList;
+
+constexpr std::uint32_t CuckooHash1(Hash hashValue)
+{
+    return hashValue & (CuckooTableSize - 1);
+}
+
+constexpr std::uint32_t CuckooHash2(Hash hashValue)
+{
+    return (hashValue >> 16) & (CuckooTableSize - 1);
+}
+
+constexpr bool CuckooLookup(Hash moveHash, CuckooMove& move)
+{
+    std::uint32_t index = CuckooHash1(moveHash);
+
+    if (CuckooHashList[index] != moveHash) {
+        index = CuckooHash2(moveHash);
+
+        if (CuckooHashList[index] != moveHash) {
+            return false;
+        }
+    }
+
+    move = CuckooMoveList[index];
+
+    return true;
+}
+
+void InitializeCuckoo();
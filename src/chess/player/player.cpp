@@ -16,6 +16,7 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <iostream>
 
 #include "player.h"
@@ -34,7 +35,7 @@
 
 extern ParameterMap chessEngineParameterMap;
 
-ChessPlayer::ChessPlayer()
+ChessPlayer::ChessPlayer() : bookRandom(std::random_device()()), evalParameters(&DefaultEvalParameters, [](const EvalParameters*) {})
 {
     this->currentBoard = 0;
 
@@ -43,30 +44,23 @@ ChessPlayer::ChessPlayer()
 
     this->parameterMap = chessEngineParameterMap;
 
-    //InitializeParameters();
+    this->evaluator.setEvalParameters(this->evalParameters.get());
+    this->searcher.setEvalParameters(this->evalParameters.get());
+    this->boardMover.setEvalParameters(this->evalParameters.get());
 }
 
 void ChessPlayer::applyPersonality(bool strip)
 {
     const std::int32_t multiplier = strip ? -1 : 1;
 
+    //Only the search parameters are shared, the evaluation ones already went into this player's own parameters
     for (Personality::iterator it = this->personality.begin(); it != this->personality.end(); ++it) {
-        const std::string& name = it->first;
-        const Score score = multiplier * it->second;
+        const ParameterMap::iterator parameter = this->parameterMap.find(it->first);
 
-        //First, make sure the parameter exists in case we're passed bad parameters
-        this->parameterMap[name];
-
-        Score* parameterScore = this->parameterMap.find(name)->second;
-        *parameterScore += score;
+        if (parameter != this->parameterMap.end()) {
+            *parameter->second += multiplier * it->second;
+        }
     }
-
-    InitializeParameters();
-
-    BoardType& board = this->getCurrentBoard();
-
-    board.materialEvaluation = board.calculateMaterialEvaluation();
-    board.pstEvaluation = board.calculatePstEvaluation();
 }
 
 TwoPlayerGameResult ChessPlayer::checkBoardGameResult(const BoardType& board) const
@@ -76,15 +70,63 @@ TwoPlayerGameResult ChessPlayer::checkBoardGameResult(const BoardType& board) co
 
 Score ChessPlayer::evaluateCurrentPosition()
 {
-    this->applyPersonality();
-
     BoardType& board = this->getCurrentBoard();
 
-    const Score result = this->evaluator.evaluate(board, Depth::ZERO, -WIN_SCORE, WIN_SCORE);
+    return this->evaluator.evaluate(board, Depth::ZERO, -WIN_SCORE, WIN_SCORE);
+}
+
+bool ChessPlayer::getBookMove(MoveType& move)
+{
+    const BoardType& board = this->getCurrentBoard();
+    const std::uint32_t gamePly = static_cast<std::uint32_t>(2 * (board.fullMoveCount - 1) + (board.sideToMove == Color::BLACK ? 1 : 0));
+
+    if (gamePly >= this->bookDepth) {
+        return false;
+    }
+
+    //1) Find the moves that stay in the book
+    ChessMoveList moveList;
+    std::vector<GameResultCount> weights;
+    std::vector<GameResultCount> gameCounts;
+
+    this->moveGenerator.DispatchGenerateAllMoves(board, moveList);
+
+    if (this->book.getBookMoves(board, moveList) > 0) {
+        //2) Weigh each by the points it scored, in half points so draws count
+        weights.reserve(moveList.size());
+
+        for (ChessMove& bookMove : moveList) {
+            BoardType nextBoard = board;
+            this->boardMover.dispatchDoMove(nextBoard, bookMove);
+
+            const ChessBookPosition bookPosition = this->book.getPosition(nextBoard.hashValue);
+
+            weights.push_back(2 * bookPosition.winCount + bookPosition.drawCount);
+            gameCounts.push_back(bookPosition.winCount + bookPosition.drawCount + bookPosition.lossCount);
+        }
+    }
+    else if (this->polyglotBook.getBookMoves(board, moveList, weights) == 0) {
+        return false;
+    }
+    else {
+        //Polyglot weights don't say how many games were played
+        gameCounts.assign(weights.size(), 0);
+    }
+
+    //3) Without any points scored, moves that were never played are all equally good, and moves that only lost are left out
+    if (std::all_of(weights.begin(), weights.end(), [](GameResultCount weight) { return weight == 0; })) {
+        std::transform(gameCounts.begin(), gameCounts.end(), weights.begin(),
+            [](GameResultCount gameCount) { return gameCount == 0 ? 1 : 0; });
+
+        if (std::all_of(weights.begin(), weights.end(), [](GameResultCount weight) { return weight == 0; })) {
+            return false;
+        }
+    }
 
-    this->stripPersonality();
+    std::discrete_distribution<std::size_t> distribution(weights.begin(), weights.end());
+    move = moveList[distribution(this->bookRandom)];
 
-    return result;
+    return true;
 }
 
 ChessSearcher::BoardType& ChessPlayer::getCurrentBoard()
@@ -104,12 +146,28 @@ void ChessPlayer::getMoveImplementation(MoveType& move)
 {
     BoardType& board = this->getCurrentBoard();
 
+    //A book move costs a lookup per legal move instead of a search
+    if (this->getBookMove(move)) {
+        this->principalVariation.clear();
+        this->clock.onSearchCompleted(0);
+
+        return;
+    }
+
     this->searcher.setClock(this->clock);
     this->searcher.iterativeDeepeningLoop(board, this->principalVariation);
 
+    this->clock.onSearchCompleted(this->searcher.getSearchTime());
+
     move = this->principalVariation[0];
 }
 
+void ChessPlayer::recalculateBoardEvaluation(BoardType& board) const
+{
+    board.materialEvaluation = board.calculateMaterialEvaluation(*this->evalParameters);
+    board.pstEvaluation = board.calculatePstEvaluation(*this->evalParameters);
+}
+
 void ChessPlayer::resetHashtable()
 {
     this->searcher.resetHashtable();
@@ -119,3 +177,22 @@ void ChessPlayer::stripPersonality()
 {
     this->applyPersonality(true);
 }
+
+void ChessPlayer::updateEvalParameters()
+{
+    //1) Build a new set from the defaults, since personalities hold changes to them
+    const std::shared_ptr<EvalParameters> evalParameters = std::make_shared<EvalParameters>(DefaultEvalParameters);
+    evalParameters->applyPersonality(this->personality);
+
+    //2) Then swap it in, leaving the old set alone for anyone still holding it
+    this->evalParameters = evalParameters;
+
+    this->evaluator.setEvalParameters(this->evalParameters.get());
+    this->searcher.setEvalParameters(this->evalParameters.get());
+    this->boardMover.setEvalParameters(this->evalParameters.get());
+
+    //3) The boards' incremental scores were calculated with the old parameters
+    for (BoardType& board : this->boardList) {
+        this->recalculateBoardEvaluation(board);
+    }
+}
@@ -19,11 +19,17 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
+#include <random>
 #include <vector>
 
 #include "../board/board.h"
 
+#include "../book/book.h"
+#include "../book/polyglot.h"
+
 #include "../eval/evaluator.h"
+#include "../eval/parameters.h"
 
 #include "../../game/personality/parametermap.h"
 #include "../../game/personality/personality.h"
@@ -37,9 +43,18 @@
 
 #include "../types/move.h"
 
+//Plies from the start of the game that are played from the book
+constexpr std::uint32_t DefaultBookDepth = 16;
+
 class ChessPlayer : public Player<ChessPlayer, ChessSearcher>
 {
 protected:
+    ChessBook book;
+    PolyglotBook polyglotBook;
+    std::uint32_t bookDepth = DefaultBookDepth;
+
+    std::mt19937 bookRandom;
+
     ChessEvaluator evaluator;
 
     ChessSearcher searcher;
@@ -54,10 +69,19 @@ protected:
     ParameterMap parameterMap;
     Personality personality;
 
+    //The evaluation parameters with the personality applied, which the evaluator, searcher and board mover point to.
+    //They're never changed once built, so they can be shared, and a new personality gets a new set.
+    std::shared_ptr<const EvalParameters> evalParameters;
+
     ChessPrincipalVariation principalVariation;
 
     ChessBoardMover boardMover;
 
+    bool getBookMove(MoveType& move);
+
+    void recalculateBoardEvaluation(BoardType& board) const;
+    void updateEvalParameters();
+
 public:
     using EventHandler = ChessSearcher::EventHandler;
     using EventHandlerSharedPtr = ChessSearcher::EventHandlerSharedPtr;
@@ -115,6 +139,11 @@ public:
         return this->clock;
     }
 
+    const ChessSearcher& getSearcher() const
+    {
+        return this->searcher;
+    }
+
     BoardType& getCurrentBoard();
     std::string getCurrentBoardFen();
 
@@ -129,6 +158,16 @@ public:
 
     void getMoveImplementation(MoveType& move);
 
+    bool loadBookFile(const std::string& bookFileName)
+    {
+        return this->book.loadFromFile(bookFileName);
+    }
+
+    bool loadPolyglotBookFile(const std::string& bookFileName)
+    {
+        return this->polyglotBook.loadFromFile(bookFileName);
+    }
+
     void loadPersonalityFile(std::string& personalityFileName)
     {
         std::fstream personalityFile;
@@ -162,6 +201,8 @@ public:
         BoardType board;
         board.resetSpecificPosition(fen);
 
+        this->recalculateBoardEvaluation(board);
+
         this->currentBoard = 0;
         this->boardList[0] = board;
 
@@ -174,6 +215,8 @@ public:
         BoardType board;
         board.resetStartingPosition();
 
+        this->recalculateBoardEvaluation(board);
+
         this->currentBoard = 0;
         this->boardList[0] = board;
 
@@ -185,16 +228,16 @@ public:
         this->currentBoard = 0;
         this->boardList[0] = board;
 
-        this->applyPersonality();
-
-        this->boardList[0].materialEvaluation = this->boardList[0].calculateMaterialEvaluation();
-        this->boardList[0].pstEvaluation = this->boardList[0].calculatePstEvaluation();
-
-        this->stripPersonality();
+        this->recalculateBoardEvaluation(this->boardList[0]);
 
         this->searcher.resetMoveHistory();
     }
 
+    void setBookDepth(std::uint32_t bookDepth)
+    {
+        this->bookDepth = bookDepth;
+    }
+
     void setClock(Clock& clock)
     {
         this->clock = clock;
@@ -203,17 +246,23 @@ public:
     void setParameter(const std::string& name, Score score)
     {
         this->personality.setParameter(name, score);
+
+        this->updateEvalParameters();
     }
 
     void setPersonality(Personality& personality)
     {
         this->personality = personality;
+
+        this->updateEvalParameters();
     }
 
     void undoMove()
     {
         if (this->currentBoard > 0) {
             this->currentBoard--;
+
+            this->searcher.removeMoveFromHistory();
         }
     }
 };
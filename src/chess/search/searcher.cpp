@@ -35,6 +35,12 @@
 #include "../board/boardmover.h"
 #include "../board/moveorderer.h"
 
+#include "../hash/cuckoo.h"
+
+#include "../tablebase/tablebase.h"
+
+#include "../../game/clock/profiler.h"
+
 //constexpr std::uint32_t HASH_MEGABYTES = 1;
 //constexpr std::uint32_t HASH_SIZE = HASH_MEGABYTES * 65536;
 
@@ -86,7 +92,7 @@ ChessSearcher::ChessSearcher()
         this->hashtable.initialize(HASH_SIZE);
     }
 
-    this->moveHistory.reserve(1024);
+    InitializeCuckoo();
 }
 
 void ChessSearcher::addMoveToHistory(ChessBoard& board, ChessMove& move)
@@ -131,14 +137,111 @@ TwoPlayerGameResult ChessSearcher::checkBoardGameResult(const ChessBoard& board,
 
 bool ChessSearcher::checkHashtable(const ChessBoard& board, HashtableEntry& hashtableEntry) const
 {
+    const ScopedCycleProfile cycleProfile(ProfilePhase::HASHTABLE_PROBE);
+
     return this->hashtable.search(hashtableEntry, board.hashValue);
 }
 
-NodeCount ChessSearcher::getNodeCount()
+bool ChessSearcher::hasGameCycle(const ChessBoard& board, Depth currentDepth) const
+{
+    //1) Going back to an earlier position takes at least three reversible plies
+    const std::uint32_t reversiblePlies = this->moveHistory.getReversiblePlies();
+
+    if (reversiblePlies < 3) {
+        return false;
+    }
+
+    const Bitboard sideToMovePieces = board.isWhiteToMove() ? board.whitePieces[PieceType::ALL] : board.blackPieces[PieceType::ALL];
+
+    for (std::uint32_t distance = 3; distance <= reversiblePlies; distance += 2) {
+        //2) The hash difference to that position has to be a single piece move
+        const Hash moveHash = board.hashValue ^ this->moveHistory.getHashValue(distance);
+
+        CuckooMove move;
+
+        if (!CuckooLookup(moveHash, move)) {
+            continue;
+        }
+
+        //3) Which isn't blocked
+        if ((InBetween(move.src, move.dst) & board.allPieces) != EmptyBitboard) {
+            continue;
+        }
+
+        //4) A cycle inside the search tree is ours to take
+        if (currentDepth > static_cast<Depth>(distance)) {
+            assert(this->verifyGameCycle(board, move));
+
+            return true;
+        }
+
+        //5) One reaching back past the root must be our move, into a position that already repeated
+        const Square src = board.pieces[move.src] == PieceType::NO_PIECE ? move.dst : move.src;
+
+        if ((sideToMovePieces & OneShiftedBy(src)) == EmptyBitboard) {
+            continue;
+        }
+
+        if (this->moveHistory.isRepeatedAt(distance)) {
+            assert(this->verifyGameCycle(board, move));
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//Debug builds play the cuckoo move and make sure the move history agrees it repeats a position
+bool ChessSearcher::verifyGameCycle(const ChessBoard& board, const CuckooMove& cuckooMove) const
+{
+    const Square src = board.pieces[cuckooMove.src] == PieceType::NO_PIECE ? cuckooMove.dst : cuckooMove.src;
+    const Square dst = src == cuckooMove.src ? cuckooMove.dst : cuckooMove.src;
+
+    //1) Only the side to move can play it now, the other side's cycles are further down the tree
+    const Bitboard sideToMovePieces = board.isWhiteToMove() ? board.whitePieces[PieceType::ALL] : board.blackPieces[PieceType::ALL];
+
+    if ((sideToMovePieces & OneShiftedBy(src)) == EmptyBitboard) {
+        return true;
+    }
+
+    //2) The move is quiet and reversible, so the earlier position has to come back
+    ChessBoard nextBoard = board;
+    ChessMove move = { src, dst };
+
+    this->boardMover.dispatchDoMove(nextBoard, move);
+
+    ChessMoveHistory moveHistory = this->moveHistory;
+    moveHistory.push_back(nextBoard, move);
+
+    return moveHistory.checkForDuplicateHash(nextBoard.hashValue) > 1;
+}
+
+std::uint32_t ChessSearcher::getHashfull() const
+{
+    return this->hashtable.getHashfull();
+}
+
+NodeCount ChessSearcher::getNodeCount() const
 {
     return this->nodeCount + this->quiescentNodeCount;
 }
 
+const SearchStatistics& ChessSearcher::getSearchStatistics() const
+{
+    return this->searchStatistics;
+}
+
+std::time_t ChessSearcher::getSearchTime() const
+{
+    return this->searchTime;
+}
+
+Depth ChessSearcher::getSelectiveDepth() const
+{
+    return this->selectiveDepth;
+}
+
 void ChessSearcher::initialize()
 {
     if (enableHistoryTable) {
@@ -155,6 +258,9 @@ void ChessSearcher::initialize()
 
     this->nodeCount = ZeroNodes;
     this->quiescentNodeCount = ZeroNodes;
+    this->selectiveDepth = Depth::ZERO;
+
+    this->searchStatistics.reset();
 
     this->hashtable.incrementAge();
 
@@ -173,11 +279,21 @@ void ChessSearcher::iterativeDeepeningLoop(const ChessBoard& board, ChessPrincip
     Score mateScore = ZERO_SCORE;
     Score previousScore = NO_SCORE;
 
+    ChessMove previousBestMove = NullMove;
+
+    NodeCount previousNodeCount = ZeroNodes, previousIterationNodeCount = ZeroNodes;
+
     bool isSearching = true;
     bool foundMateSolution = false;
 
     this->searchStack[0].moveCount = this->moveGenerator.DispatchGenerateAllMoves(board, this->rootMoveList);
 
+    //Only search the moves that keep the best tablebase result with the fastest progress
+    if (enableTablebaseRootFilter
+        && FilterTablebaseRootMoves(board, this->rootMoveList)) {
+        this->searchStack[0].moveCount = this->rootMoveList.size();
+    }
+
     ChessMoveOrderer moveOrderer;
     moveOrderer.reorderMoves(board, this->rootMoveList, &this->searchStack[0], this->historyTable, this->mateHistoryTable);
 
@@ -279,12 +395,26 @@ void ChessSearcher::iterativeDeepeningLoop(const ChessBoard& board, ChessPrincip
 
         this->searchEventHandlerList.onDepthCompleted(principalVariation, time, nodeCount, score, searchDepth);
 
+        if (previousIterationNodeCount != ZeroNodes) {
+            this->searchStatistics.increment(SearchStatistic::ITERATION_NODES, nodeCount - previousNodeCount);
+            this->searchStatistics.increment(SearchStatistic::PREVIOUS_ITERATION_NODES, previousIterationNodeCount);
+        }
+
+        previousIterationNodeCount = nodeCount - previousNodeCount;
+        previousNodeCount = nodeCount;
+
+        const ChessMove bestMove = principalVariation.size() > 0 ? principalVariation[0] : NullMove;
+        const bool bestMoveChanged = bestMove != previousBestMove;
+
+        this->clock.onDepthCompleted(searchDepth, score, bestMoveChanged, nodeCount);
+        previousBestMove = bestMove;
+
         if (foundMateSolution) {
             const Depth distanceToMate = DistanceToWin(score);
             isSearching = searchDepth > distanceToMate * 2 ? false : isSearching;
         }
 
-        isSearching = isSearching && this->clock.shouldContinueSearch(searchDepth, this->getNodeCount());
+        isSearching = isSearching && this->clock.shouldStartNextDepth(searchDepth, this->getNodeCount());
 
         //std::cout << "Finished Depth " << searchDepth << std::endl;
 
@@ -294,6 +424,11 @@ void ChessSearcher::iterativeDeepeningLoop(const ChessBoard& board, ChessPrincip
 
     //this->verifyPrincipalVariation(board, principalVariation, previousScore, searchDepth);
 
+    this->searchTime = this->clock.getElapsedTime(this->getNodeCount());
+
+    MergeSearchStatistics(this->searchStatistics);
+    MergeCycleProfile();
+
     this->searchEventHandlerList.onSearchCompleted(board);
 }
 
@@ -327,6 +462,10 @@ Score ChessSearcher::quiescenceSearch(ChessBoard& board, ChessSearchStack* searc
     }
 
     this->quiescentNodeCount++;
+    this->searchStatistics.increment(SearchStatistic::QUIESCENT_NODES);
+
+    this->selectiveDepth = std::max(this->selectiveDepth, currentDepth);
+
     searchStack->bestMove = NullMove;
 
     //5) Check Hashtable
@@ -341,7 +480,11 @@ Score ChessSearcher::quiescenceSearch(ChessBoard& board, ChessSearchStack* searc
         HashtableEntry hashtableEntry;
         hashFound = this->checkHashtable(board, hashtableEntry);
 
+        this->searchStatistics.increment(SearchStatistic::HASHTABLE_PROBES);
+
         if (hashFound) {
+            this->searchStatistics.increment(SearchStatistic::HASHTABLE_HITS);
+
             const HashtableEntryType hashtableEntryType = hashtableEntry.getType();
             hashDepthLeft = hashtableEntry.getDepthLeft();
             hashScore = hashtableEntry.getScore(currentDepth);
@@ -363,10 +506,14 @@ Score ChessSearcher::quiescenceSearch(ChessBoard& board, ChessSearchStack* searc
                     assert(0);
                     break;
                 case HashtableEntryType::EXACT_VALUE:
+                    this->searchStatistics.increment(SearchStatistic::HASHTABLE_CUTOFFS);
+
                     searchStack->bestMove = NullMove;
                     return hashScore;
                 case HashtableEntryType::LOWER_BOUND:
                     if (hashScore >= beta) {
+                        this->searchStatistics.increment(SearchStatistic::HASHTABLE_CUTOFFS);
+
                         searchStack->bestMove = NullMove;
                         return hashScore;
                     }
@@ -374,6 +521,8 @@ Score ChessSearcher::quiescenceSearch(ChessBoard& board, ChessSearchStack* searc
                     break;
                 case HashtableEntryType::UPPER_BOUND:
                     if (hashScore < alpha) {
+                        this->searchStatistics.increment(SearchStatistic::HASHTABLE_CUTOFFS);
+
                         searchStack->bestMove = NullMove;
                         return hashScore;
                     }
@@ -447,7 +596,7 @@ Score ChessSearcher::quiescenceSearch(ChessBoard& board, ChessSearchStack* searc
         const std::int32_t phase = board.getPhase();
         if (enableQuiescenceEarlyExit
             && !isInCheck) {
-            const Score capturedPieceScore = MaterialParameters[capturedPiece](phase);
+            const Score capturedPieceScore = this->evaluator.getEvalParameters().material[capturedPiece](phase);
             const Score lazyScore = searchStack->staticEvaluation + capturedPieceScore;
 
             const Score earlyExitThreshold = 2 * PAWN_SCORE;
@@ -560,6 +709,13 @@ void ChessSearcher::resetHashtable()
     this->hashtable.reset();
 }
 
+void ChessSearcher::removeMoveFromHistory()
+{
+    if (this->moveHistory.size() > 0) {
+        this->moveHistory.pop_back();
+    }
+}
+
 void ChessSearcher::resetMoveHistory()
 {
     this->moveHistory.clear();
@@ -567,6 +723,9 @@ void ChessSearcher::resetMoveHistory()
 
 Score ChessSearcher::rootSearch(const ChessBoard& board, ChessPrincipalVariation& principalVariation, Score alpha, Score beta, Depth maxDepth)
 {
+    //Everything the search does outside the other phases is charged to the search itself
+    const ScopedCycleProfile cycleProfile(ProfilePhase::SEARCH);
+
     //std::cout << "Start Root Search" << std::endl;
 
     Score bestScore = -INFINITE_SCORE;
@@ -729,6 +888,21 @@ Score ChessSearcher::search(ChessBoard& board, ChessSearchStack* searchStack, Sc
         //return DRAW_SCORE + ((this->getNodeCount() & 2) == 0 ? 1 : -1) * (this->getNodeCount() & 1);
     }
 
+    //2a) If we can move back into an earlier position, we can always settle for the draw
+    if (enableUpcomingRepetition
+        && alpha < DRAW_SCORE
+        && this->hasGameCycle(board, currentDepth)) {
+        alpha = DRAW_SCORE;
+
+        if (alpha >= beta) {
+            if constexpr (nodeType == NodeType::PV) {
+                principalVariation.clear();
+            }
+
+            return alpha;
+        }
+    }
+
     //3) Mate Distance Pruning
     if (enableMateDistancePruning) {
         alpha = std::max(LostInDepth(currentDepth - Depth::ONE), alpha);
@@ -757,6 +931,7 @@ Score ChessSearcher::search(ChessBoard& board, ChessSearchStack* searchStack, Sc
     assert(depthLeft > Depth::ZERO);
 
     this->nodeCount++;
+    this->searchStatistics.increment(SearchStatistic::INTERIOR_NODES);
 
     //5) Check Hashtable
     searchStack->hashDepth = Depth::ZERO;
@@ -768,7 +943,11 @@ Score ChessSearcher::search(ChessBoard& board, ChessSearchStack* searchStack, Sc
         HashtableEntry hashtableEntry;
         searchStack->hashFound = this->checkHashtable(board, hashtableEntry);
 
+        this->searchStatistics.increment(SearchStatistic::HASHTABLE_PROBES);
+
         if (searchStack->hashFound) {
+            this->searchStatistics.increment(SearchStatistic::HASHTABLE_HITS);
+
             const HashtableEntryType hashtableEntryType = hashtableEntry.getType();
             searchStack->hashDepth = hashtableEntry.getDepthLeft();
             hashScore = hashtableEntry.getScore(currentDepth);
@@ -795,10 +974,14 @@ Score ChessSearcher::search(ChessBoard& board, ChessSearchStack* searchStack, Sc
                     assert(0);
                     break;
                 case HashtableEntryType::EXACT_VALUE:
+                    this->searchStatistics.increment(SearchStatistic::HASHTABLE_CUTOFFS);
+
                     searchStack->bestMove = NullMove;
                     return hashScore;
                 case HashtableEntryType::LOWER_BOUND:
                     if (hashScore >= beta) {
+                        this->searchStatistics.increment(SearchStatistic::HASHTABLE_CUTOFFS);
+
                         searchStack->bestMove = NullMove;
                         return hashScore;
                     }
@@ -806,6 +989,8 @@ Score ChessSearcher::search(ChessBoard& board, ChessSearchStack* searchStack, Sc
                     break;
                 case HashtableEntryType::UPPER_BOUND:
                     if (hashScore < alpha) {
+                        this->searchStatistics.increment(SearchStatistic::HASHTABLE_CUTOFFS);
+
                         searchStack->bestMove = NullMove;
                         return hashScore;
                     }
@@ -838,6 +1023,17 @@ Score ChessSearcher::search(ChessBoard& board, ChessSearchStack* searchStack, Sc
         }
     }
 
+    //5a) Tablebases know the exact result
+    TablebaseWdl tablebaseWdl;
+
+    if (enableTablebaseProbe
+        && nodeType != NodeType::PV
+        && ShouldProbeTablebase(board, depthLeft)
+        && ProbeTablebaseWdl(board, tablebaseWdl)) {
+        searchStack->bestMove = NullMove;
+        return GetTablebaseScore(tablebaseWdl, currentDepth);
+    }
+
     //6) Get static Evaluation
     if (isInCheck) {
         searchStack->staticEvaluation = LostInDepth(currentDepth);
@@ -886,6 +1082,8 @@ Score ChessSearcher::search(ChessBoard& board, ChessSearchStack* searchStack, Sc
             && depthLeft < Depth::EIGHT
             && searchStack->staticEvaluation < BASICALLY_WINNING_SCORE
             && searchStack->staticEvaluation >= beta + 65 * (isImproving ? depthLeft - Depth::ONE : depthLeft)) {
+                this->searchStatistics.increment(SearchStatistic::REVERSE_FUTILITY_CUTOFFS);
+
                 return searchStack->staticEvaluation;
         }
 
@@ -911,16 +1109,23 @@ Score ChessSearcher::search(ChessBoard& board, ChessSearchStack* searchStack, Sc
             this->boardMover.doNullMove(newBoard);
 
             searchStack->currentMove = NullMove;
+            this->moveHistory.push_back(newBoard, NullMove, true);
+
+            this->searchStatistics.increment(SearchStatistic::NULL_MOVE_SEARCHES);
 
             const Depth nullReduction = Depth::THREE;
             const Score nullScore = -this->search<NodeType::ALL>(newBoard, searchStack + 1, -beta, -beta + 1, maxDepth - nullReduction, currentDepth + Depth::ONE);
 
+            this->moveHistory.pop_back();
+
             searchStack->hasMateThreat = IsLossScore(nullScore);
 
             const bool isMateScore = IsMateScore(nullScore);
 
             if (!isMateScore
                 && nullScore >= beta) {
+                this->searchStatistics.increment(SearchStatistic::NULL_MOVE_CUTOFFS);
+
                 if (enableNullMoveVerification) {
                     const Depth nullVerificationReduction = Depth::THREE;
                     const Score verifiedNullScore = this->search<nodeType>(board, searchStack, beta - 1, beta, maxDepth - nullVerificationReduction, currentDepth);
@@ -1004,12 +1209,16 @@ Score ChessSearcher::search(ChessBoard& board, ChessSearchStack* searchStack, Sc
             const Score score = -this->quiescenceSearch<nextNodeType>(nextBoard, searchStack + 1, -probCutBeta, -probCutBeta + 1, currentDepth + Depth::ONE, currentDepth + Depth::ONE);
 
             if (score >= probCutBeta) {
+                this->searchStatistics.increment(SearchStatistic::PROBCUT_SEARCHES);
+
                 const Depth probCutReduction = Depth::FOUR;
                 const Score score = -this->search<nextNodeType>(nextBoard, searchStack + 1, -probCutBeta, -probCutBeta + 1, maxDepth - probCutReduction, currentDepth + Depth::ONE);
 
                 this->moveHistory.pop_back();
 
                 if (score >= probCutBeta) {
+                    this->searchStatistics.increment(SearchStatistic::PROBCUT_CUTOFFS);
+
                     this->saveToHashtable(board, move, alpha, beta, score, currentDepth, depthLeft - probCutReduction);
 
                     return score;
@@ -1142,7 +1351,8 @@ Score ChessSearcher::searchLoop(ChessBoard& board, ChessSearchStack* searchStack
 
         const bool isQuietMove = capturedPiece == PieceType::NO_PIECE && promotionPiece == PieceType::NO_PIECE;
 
-        const Score gain = (MaterialParameters[promotionPiece] + MaterialParameters[capturedPiece])(phase);
+        const EvalParameters& evalParameters = this->evaluator.getEvalParameters();
+        const Score gain = (evalParameters.material[promotionPiece] + evalParameters.material[capturedPiece])(phase);
 
         //3) Early Pruning
         if (nodeType != NodeType::PV
@@ -1155,6 +1365,8 @@ Score ChessSearcher::searchLoop(ChessBoard& board, ChessSearchStack* searchStack
             move.seeScore = this->staticExchangeEvaluator.staticExchangeEvaluation(board, move);
 
             if (move.seeScore < Score(-185) * depthLeft) {
+                this->searchStatistics.increment(SearchStatistic::PRUNED_MOVES);
+
                 continue;
             }
         }
@@ -1323,6 +1535,8 @@ Score ChessSearcher::searchLoop(ChessBoard& board, ChessSearchStack* searchStack
             if (/*nodeType != NodeType::PV
                 && */depthLeft < Depth::SEVEN
                 && searchStack->staticEvaluation + PruningMargin(depthLeft, movesSearched, phase) < alpha) {
+                this->searchStatistics.increment(SearchStatistic::PRUNED_MOVES);
+
                 continue;
             }
 
@@ -1367,17 +1581,33 @@ Score ChessSearcher::searchLoop(ChessBoard& board, ChessSearchStack* searchStack
 
         Score score = NO_SCORE;
 
+        this->searchStatistics.increment(SearchStatistic::MOVES_SEARCHED);
+
         if (!isPvNode
             || movesSearched > ZeroNodes) {
             score = -this->search<NodeType::CUT>(nextBoard, searchStack + 1, -alpha - 1, -alpha, maxDepth + extensions, currentDepth + Depth::ONE);
 
+            if (!isPvNode
+                && extensions < Depth::ZERO) {
+                this->searchStatistics.increment(SearchStatistic::REDUCED_SEARCHES);
+            }
+
             if (!isPvNode
                 && score > alpha
                 && extensions < Depth::ZERO) {
+                this->searchStatistics.increment(SearchStatistic::REDUCED_RESEARCHES);
+
                 score = -this->search<NodeType::CUT>(nextBoard, searchStack + 1, -alpha - 1, -alpha, maxDepth, currentDepth + Depth::ONE);
             }
         }
 
+        if (isPvNode
+            && movesSearched > ZeroNodes
+            && score > alpha
+            && score < beta) {
+            this->searchStatistics.increment(SearchStatistic::PV_RESEARCHES);
+        }
+
         if (isPvNode
             && (movesSearched == ZeroNodes || (score > alpha && score < beta))) {
             extensions = extensions < Depth::ZERO ? Depth::ZERO : extensions;
@@ -1402,6 +1632,9 @@ Score ChessSearcher::searchLoop(ChessBoard& board, ChessSearchStack* searchStack
         if (score > alpha) {
             //11) Check if the new score > beta.  Save some statistics and return.
             if (score >= beta) {
+                this->searchStatistics.increment(SearchStatistic::BETA_CUTOFFS);
+                this->searchStatistics.increment(SearchStatistic::FIRST_MOVE_CUTOFFS, movesSearched == ZeroNodes ? OneNode : ZeroNodes);
+
                 if (enableHistoryTable) {
                     if (isQuietMove) {
                         const std::uint32_t delta = 1;// HistoryDelta(depthLeft, phase);
@@ -1457,6 +1690,12 @@ void ChessSearcher::setClock(const Clock& clock)
     this->clock = clock;
 }
 
+void ChessSearcher::setEvalParameters(const EvalParameters* evalParameters)
+{
+    this->evaluator.setEvalParameters(evalParameters);
+    this->boardMover.setEvalParameters(evalParameters);
+}
+
 void ChessSearcher::verifyPrincipalVariation(const ChessBoard& board, ChessPrincipalVariation& principalVariation, Score score, Depth depth)
 {
     assert(principalVariation.size() > 0);
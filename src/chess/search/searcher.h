@@ -42,6 +42,11 @@ constexpr bool enableRazoring = enableAllSearchFeatures && true;
 constexpr bool enableReductions = enableAllSearchFeatures && true;
 constexpr bool enableProbcut = enableAllSearchFeatures && true;
 
+constexpr bool enableUpcomingRepetition = enableAllSearchFeatures && true;
+
+constexpr bool enableTablebaseProbe = enableAllSearchFeatures && true;
+constexpr bool enableTablebaseRootFilter = enableAllSearchFeatures && true;
+
 constexpr bool enableSearchHashtable = enableAllSearchFeatures && true;
 constexpr bool enableQuiescenceSearchHashtable = enableAllSearchFeatures && enableSearchHashtable && true;
 
@@ -56,6 +61,7 @@ constexpr bool enableQuiescenceEarlyExit = enableAllSearchFeatures && false;
 
 #include "../eval/evaluator.h"
 
+#include "../hash/cuckoo.h"
 //#include "../hash/chesshashtable.h"
 #include "../../game/search/hashtable.h"
 
@@ -68,6 +74,7 @@ constexpr bool enableQuiescenceEarlyExit = enableAllSearchFeatures && false;
 #include "../types/searchstack.h"
 
 #include "history.h"
+#include "statistics.h"
 
 #include "chesspv.h"
 
@@ -110,7 +117,7 @@ protected:
     ChessMoveOrderer moveOrderer;
     const ChessStaticExchangeEvaluator staticExchangeEvaluator;
 
-    const ChessBoardMover boardMover;
+    ChessBoardMover boardMover;
 
     Hashtable hashtable;
 
@@ -120,6 +127,8 @@ protected:
     NodeCount nodeCount = 0;
     NodeCount quiescentNodeCount = 0;
 
+    SearchStatistics searchStatistics;
+
     std::array<ChessSearchStack, SearchStackSize> searchStack;
 
     SearchEventHandlerList<ChessBoard, ChessPrincipalVariation> searchEventHandlerList;
@@ -128,6 +137,8 @@ protected:
     SquareSquareHistoryTable mateHistoryTable[2];
 
     Depth rootSearchDepth;
+    Depth selectiveDepth = Depth::ZERO;
+    std::time_t searchTime = 0;
 
     bool abortedSearch = false;
 
@@ -136,6 +147,9 @@ protected:
     template <NodeType nodeType>
     Score quiescenceSearch(ChessBoard& board, ChessSearchStack* searchStack, Score alpha, Score beta, Depth maxDepth, Depth currentDepth);
 
+    bool hasGameCycle(const ChessBoard& board, Depth currentDepth) const;
+    bool verifyGameCycle(const ChessBoard& board, const CuckooMove& cuckooMove) const;
+
     Score rootSearch(const ChessBoard& board, ChessPrincipalVariation& principalVariation, Score alpha, Score beta, Depth maxDepth);
 
     bool saveToHashtable(const ChessBoard& board, const ChessMove& move, Score alpha, Score beta, Score score, Depth currentDepth, Depth depthLeft);
@@ -174,16 +188,24 @@ public:
 
     TwoPlayerGameResult checkBoardGameResult(const ChessBoard& board, bool checkMoveCount, bool isPrincipalVariation) const;
 
-    NodeCount getNodeCount();
+    std::uint32_t getHashfull() const;
+    NodeCount getNodeCount() const;
+    const SearchStatistics& getSearchStatistics() const;
+    std::time_t getSearchTime() const;
+    Depth getSelectiveDepth() const;
 
     void initialize();
 
     void iterativeDeepeningLoop(const ChessBoard& board, ChessPrincipalVariation& principalVariation);
 
+    void removeMoveFromHistory();
     void resetHashtable();
     void resetMoveHistory();
 
     void setClock(const Clock& clock);
 
+    //Boards passed to the search have to have had their material and piece square scores calculated with these
+    void setEvalParameters(const EvalParameters* evalParameters);
+
     bool wasSearchAborted();
 };
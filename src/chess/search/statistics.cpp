@@ -0,0 +1,96 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+
+#include "statistics.h"
+
+static std::mutex SearchStatisticsMutex;
+static SearchStatistics SharedSearchStatistics;
+
+static double Percentage(NodeCount part, NodeCount total)
+{
+    return total == ZeroNodes ? 0.0 : 100.0 * double(part) / double(total);
+}
+
+static double Ratio(NodeCount numerator, NodeCount denominator)
+{
+    return denominator == ZeroNodes ? 0.0 : double(numerator) / double(denominator);
+}
+
+void SearchStatistics::merge(const SearchStatistics& searchStatistics)
+{
+    for (std::uint32_t i = 0; i < this->counters.size(); i++) {
+        this->counters[i] += searchStatistics.counters[i];
+    }
+}
+
+void SearchStatistics::print() const
+{
+    const NodeCount interiorNodes = this->get(SearchStatistic::INTERIOR_NODES);
+    const NodeCount quiescentNodes = this->get(SearchStatistic::QUIESCENT_NODES);
+    const NodeCount hashtableProbes = this->get(SearchStatistic::HASHTABLE_PROBES);
+    const NodeCount nullMoveSearches = this->get(SearchStatistic::NULL_MOVE_SEARCHES);
+    const NodeCount probcutSearches = this->get(SearchStatistic::PROBCUT_SEARCHES);
+    const NodeCount reducedSearches = this->get(SearchStatistic::REDUCED_SEARCHES);
+    const NodeCount betaCutoffs = this->get(SearchStatistic::BETA_CUTOFFS);
+
+    std::cout << std::fixed << std::setprecision(2)
+        << "Nodes: " << interiorNodes + quiescentNodes << ", quiescence " << Percentage(quiescentNodes, interiorNodes + quiescentNodes) << "%" << std::endl
+        << "Hashtable: " << hashtableProbes << " probes, hits " << Percentage(this->get(SearchStatistic::HASHTABLE_HITS), hashtableProbes)
+            << "%, cutoffs " << Percentage(this->get(SearchStatistic::HASHTABLE_CUTOFFS), hashtableProbes) << "%" << std::endl
+        << "Reverse futility: " << this->get(SearchStatistic::REVERSE_FUTILITY_CUTOFFS) << " cutoffs, " << Percentage(this->get(SearchStatistic::REVERSE_FUTILITY_CUTOFFS), interiorNodes) << "% of nodes" << std::endl
+        << "Null move: " << nullMoveSearches << " searches, cutoffs " << Percentage(this->get(SearchStatistic::NULL_MOVE_CUTOFFS), nullMoveSearches) << "%" << std::endl
+        << "ProbCut: " << probcutSearches << " searches, cutoffs " << Percentage(this->get(SearchStatistic::PROBCUT_CUTOFFS), probcutSearches) << "%" << std::endl
+        << "Pruned moves: " << this->get(SearchStatistic::PRUNED_MOVES) << std::endl
+        << "Reductions: " << reducedSearches << " searches, re-searched " << Percentage(this->get(SearchStatistic::REDUCED_RESEARCHES), reducedSearches) << "%" << std::endl
+        << "PV re-searches: " << this->get(SearchStatistic::PV_RESEARCHES) << std::endl
+        << "Beta cutoffs: " << betaCutoffs << ", on the first move " << Percentage(this->get(SearchStatistic::FIRST_MOVE_CUTOFFS), betaCutoffs) << "%" << std::endl
+        << "Branching factor: " << Ratio(this->get(SearchStatistic::MOVES_SEARCHED), interiorNodes) << " moves per node, "
+            << Ratio(this->get(SearchStatistic::ITERATION_NODES), this->get(SearchStatistic::PREVIOUS_ITERATION_NODES)) << " effective" << std::endl;
+}
+
+void SearchStatistics::reset()
+{
+    this->counters.fill(ZeroNodes);
+}
+
+void MergeSearchStatistics(const SearchStatistics& searchStatistics)
+{
+    if constexpr (enableSearchStatistics) {
+        std::lock_guard<std::mutex> lock(SearchStatisticsMutex);
+
+        SharedSearchStatistics.merge(searchStatistics);
+    }
+}
+
+SearchStatistics GetSearchStatistics()
+{
+    std::lock_guard<std::mutex> lock(SearchStatisticsMutex);
+
+    return SharedSearchStatistics;
+}
+
+void ResetSearchStatistics()
+{
+    std::lock_guard<std::mutex> lock(SearchStatisticsMutex);
+
+    SharedSearchStatistics.reset();
+}
@@ -0,0 +1,99 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "../../game/types/nodecount.h"
+
+//Counting costs a few percent of speed, so the counters only exist in builds made with SEARCH_STATISTICS defined
+#if defined(SEARCH_STATISTICS)
+constexpr bool enableSearchStatistics = true;
+#else
+constexpr bool enableSearchStatistics = false;
+#endif
+
+enum SearchStatistic : std::uint32_t {
+    INTERIOR_NODES,
+    QUIESCENT_NODES,
+
+    HASHTABLE_PROBES,
+    HASHTABLE_HITS,
+    HASHTABLE_CUTOFFS,
+
+    REVERSE_FUTILITY_CUTOFFS,
+
+    NULL_MOVE_SEARCHES,
+    NULL_MOVE_CUTOFFS,
+
+    PROBCUT_SEARCHES,
+    PROBCUT_CUTOFFS,
+
+    PRUNED_MOVES,
+
+    REDUCED_SEARCHES,
+    REDUCED_RESEARCHES,
+    PV_RESEARCHES,
+
+    MOVES_SEARCHED,
+    BETA_CUTOFFS,
+    FIRST_MOVE_CUTOFFS,
+
+    //Nodes spent on each completed depth, and on the one before it, for the effective branching factor
+    ITERATION_NODES,
+    PREVIOUS_ITERATION_NODES,
+
+    SEARCHSTATISTIC_COUNT
+};
+
+class SearchStatistics
+{
+protected:
+    std::array<NodeCount, enableSearchStatistics ? static_cast<std::size_t>(SearchStatistic::SEARCHSTATISTIC_COUNT) : 0> counters = {};
+public:
+    SearchStatistics() = default;
+    ~SearchStatistics() = default;
+
+    constexpr NodeCount get(SearchStatistic searchStatistic) const
+    {
+        if constexpr (enableSearchStatistics) {
+            return this->counters[searchStatistic];
+        }
+        else {
+            return ZeroNodes;
+        }
+    }
+
+    constexpr void increment(SearchStatistic searchStatistic, NodeCount count = OneNode)
+    {
+        if constexpr (enableSearchStatistics) {
+            this->counters[searchStatistic] += count;
+        }
+    }
+
+    void merge(const SearchStatistics& searchStatistics);
+    void print() const;
+    void reset();
+};
+
+//Searchers count on their own, and add their counts to the shared totals once each search completes
+void MergeSearchStatistics(const SearchStatistics& searchStatistics);
+SearchStatistics GetSearchStatistics();
+void ResetSearchStatistics();
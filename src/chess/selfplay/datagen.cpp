@@ -0,0 +1,206 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <memory>
+#include <random>
+
+#include "datagen.h"
+
+#include "../board/attackgenerator.h"
+#include "../board/boardmover.h"
+#include "../board/movegenerator.h"
+
+#include "../search/searcher.h"
+
+#include "../tablebase/tablebase.h"
+
+//Remembers the score of the last depth the search finished
+class DataGeneratorSearchEventHandler : public SearchEventHandler<ChessBoard, ChessPrincipalVariation>
+{
+public:
+    Score score = NO_SCORE;
+
+    void onLineCompleted(const ChessPrincipalVariation&, std::time_t, NodeCount, Score, Depth) {}
+
+    void onDepthCompleted(const ChessPrincipalVariation&, std::time_t, NodeCount, Score score, Depth)
+    {
+        this->score = score;
+    }
+
+    void onSearchCompleted(const ChessBoard&) {}
+};
+
+ChessDataGenerator::ChessDataGenerator(const DataGeneratorSettings& settings, std::uint32_t threadCount)
+    : settings(settings), threadPool(threadCount)
+{
+}
+
+void ChessDataGenerator::savePositions(const std::vector<DataGeneratorPosition>& positions)
+{
+    std::lock_guard<std::mutex> lock(this->outputMutex);
+
+    for (const DataGeneratorPosition& position : positions) {
+        this->positionWriter.write(PackPosition(position.board, position.score, position.result));
+    }
+
+    this->positionCount += positions.size();
+}
+
+void ChessDataGenerator::playGames()
+{
+    const ChessAttackGenerator attackGenerator;
+    const ChessBoardMover boardMover;
+    const ChessMoveGenerator moveGenerator;
+
+    std::unique_ptr<ChessSearcher> searcher = std::make_unique<ChessSearcher>();
+    std::shared_ptr<DataGeneratorSearchEventHandler> eventHandler = std::make_shared<DataGeneratorSearchEventHandler>();
+
+    ChessSearcher::EventHandlerSharedPtr searchEventHandler = eventHandler;
+    searcher->addSearchEventHandler(searchEventHandler);
+
+    std::mt19937_64 random(std::random_device{}());
+
+    Clock clock;
+    clock.setClockNodes(this->settings.nodesPerMove);
+
+    while (this->nextGame++ < this->settings.gameCount) {
+        ChessBoard board;
+        board.resetStartingPosition();
+
+        searcher->resetHashtable();
+        searcher->resetMoveHistory();
+
+        std::vector<DataGeneratorPosition> positions;
+        TwoPlayerGameResult whiteResult = TwoPlayerGameResult::NO_GAMERESULT;
+
+        std::uint32_t whiteWinPlies = 0, blackWinPlies = 0, drawPlies = 0;
+
+        for (std::uint32_t ply = 0; whiteResult == TwoPlayerGameResult::NO_GAMERESULT; ply++) {
+            const bool isWhiteToMove = board.sideToMove == Color::WHITE;
+
+            //1) Mates, stalemates and draws by rule end the game
+            const TwoPlayerGameResult gameResult = searcher->checkBoardGameResult(board, true, true);
+
+            if (gameResult != TwoPlayerGameResult::NO_GAMERESULT) {
+                whiteResult = isWhiteToMove ? gameResult : -gameResult;
+                break;
+            }
+
+            if (ply >= this->settings.maxPlies) {
+                whiteResult = TwoPlayerGameResult::DRAW;
+                break;
+            }
+
+            ChessMove move;
+
+            if (ply < this->settings.randomPlies) {
+                //2) Open with random moves
+                ChessMoveList moveList;
+                moveGenerator.DispatchGenerateAllMoves(board, moveList);
+
+                move = moveList[random() % moveList.size()];
+            }
+            else {
+                //3) Then search, and keep quiet positions with ordinary scores
+                ChessPrincipalVariation principalVariation;
+
+                eventHandler->score = NO_SCORE;
+
+                searcher->setClock(clock);
+                searcher->iterativeDeepeningLoop(board, principalVariation);
+
+                if (principalVariation.size() == 0 || eventHandler->score == NO_SCORE) {
+                    break;
+                }
+
+                const Score score = eventHandler->score;
+                move = principalVariation[0];
+
+                if (!IsMateScore(score)
+                    && !attackGenerator.dispatchIsInCheck(board)
+                    && board.pieceAt(move.dst) == PieceType::NO_PIECE
+                    && move.promotionPiece == PieceType::NO_PIECE) {
+                    positions.push_back({ board, score, TwoPlayerGameResult::NO_GAMERESULT });
+                }
+
+                //4) Adjudicate games both sides agree on, and tablebase positions
+                TablebaseWdl wdl;
+
+                //The score is from the side to move, so count plies from white's point of view
+                const Score whiteScore = isWhiteToMove ? score : -score;
+
+                whiteWinPlies = whiteScore >= this->settings.winAdjudicationScore ? whiteWinPlies + 1 : 0;
+                blackWinPlies = whiteScore <= -this->settings.winAdjudicationScore ? blackWinPlies + 1 : 0;
+                drawPlies = ply >= this->settings.drawAdjudicationStartPly && std::abs(score) <= this->settings.drawAdjudicationScore ? drawPlies + 1 : 0;
+
+                if (whiteWinPlies >= this->settings.winAdjudicationPlies) {
+                    whiteResult = TwoPlayerGameResult::WIN;
+                }
+                else if (blackWinPlies >= this->settings.winAdjudicationPlies) {
+                    whiteResult = TwoPlayerGameResult::LOSS;
+                }
+                else if (drawPlies >= this->settings.drawAdjudicationPlies) {
+                    whiteResult = TwoPlayerGameResult::DRAW;
+                }
+                else if (ProbeTablebaseWdl(board, wdl)) {
+                    const TwoPlayerGameResult sideToMoveResult = wdl == TABLEBASE_WIN ? TwoPlayerGameResult::WIN
+                        : (wdl == TABLEBASE_LOSS ? TwoPlayerGameResult::LOSS : TwoPlayerGameResult::DRAW);
+                    whiteResult = isWhiteToMove ? sideToMoveResult : -sideToMoveResult;
+                }
+
+                if (whiteResult != TwoPlayerGameResult::NO_GAMERESULT) {
+                    break;
+                }
+            }
+
+            boardMover.dispatchDoMove(board, move);
+            searcher->addMoveToHistory(board, move);
+        }
+
+        if (whiteResult == TwoPlayerGameResult::NO_GAMERESULT) {
+            continue;
+        }
+
+        //5) Every position learns the result from its own side's point of view
+        for (DataGeneratorPosition& position : positions) {
+            position.result = position.board.sideToMove == Color::WHITE ? whiteResult : -whiteResult;
+        }
+
+        this->savePositions(positions);
+    }
+}
+
+bool ChessDataGenerator::generate(const std::string& fileName)
+{
+    if (!this->positionWriter.open(fileName, true)) {
+        return false;
+    }
+
+    this->nextGame = 0;
+    this->positionCount = 0;
+
+    //Each thread plays whole games with its own searcher
+    for (std::uint32_t i = 0; i < this->threadPool.size(); i++) {
+        this->threadPool.submit([this]() { this->playGames(); });
+    }
+
+    this->threadPool.wait();
+
+    return this->positionWriter.close();
+}
@@ -0,0 +1,86 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+#include "../board/board.h"
+
+#include "packedposition.h"
+
+#include "../../game/threads/threadpool.h"
+#include "../../game/types/nodecount.h"
+#include "../../game/types/result.h"
+#include "../../game/types/score.h"
+
+struct DataGeneratorSettings {
+    std::uint64_t gameCount = 10000;
+    NodeCount nodesPerMove = 5000;
+
+    //Random moves played before the engine takes over, so every game is different
+    std::uint32_t randomPlies = 8;
+
+    //A game is adjudicated once both sides agree on the score for this many plies
+    Score winAdjudicationScore = UNIT_SCORE * 10;
+    std::uint32_t winAdjudicationPlies = 4;
+
+    Score drawAdjudicationScore = UNIT_SCORE / 20;
+    std::uint32_t drawAdjudicationPlies = 12;
+    std::uint32_t drawAdjudicationStartPly = 60;
+
+    std::uint32_t maxPlies = 400;
+};
+
+//One searched position of a self-play game: the board, the search score and the game result, both for the side to move
+struct DataGeneratorPosition {
+    ChessBoard board;
+    Score score;
+    TwoPlayerGameResult result;
+};
+
+class ChessDataGenerator
+{
+protected:
+    DataGeneratorSettings settings;
+
+    ThreadPool threadPool;
+
+    std::mutex outputMutex;
+    PackedPositionWriter positionWriter;
+
+    std::atomic<std::uint64_t> nextGame = 0;
+    std::atomic<std::uint64_t> positionCount = 0;
+
+    void playGames();
+    void savePositions(const std::vector<DataGeneratorPosition>& positions);
+public:
+    ChessDataGenerator(const DataGeneratorSettings& settings, std::uint32_t threadCount = 0);
+
+    bool generate(const std::string& fileName);
+
+    std::uint64_t getPositionCount() const
+    {
+        return this->positionCount;
+    }
+};
@@ -0,0 +1,205 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#include "match.h"
+
+#include "../board/boardmover.h"
+
+#include "../search/searcher.h"
+
+#include "../tablebase/tablebase.h"
+
+ChessMatch::ChessMatch(const MatchSettings& settings, std::uint32_t threadCount)
+    : settings(settings), threadPool(threadCount), sprt(settings.sprt)
+{
+    for (MatchEngine& engine : this->engines) {
+        engine.evalParameters = std::shared_ptr<const EvalParameters>(&DefaultEvalParameters, [](const EvalParameters*) {});
+    }
+}
+
+void ChessMatch::addGamePair(TwoPlayerGameResult firstResult, TwoPlayerGameResult secondResult)
+{
+    std::lock_guard<std::mutex> lock(this->resultMutex);
+
+    //A game cut short counts for neither side, and so does its pair
+    if (firstResult == TwoPlayerGameResult::NO_GAMERESULT || secondResult == TwoPlayerGameResult::NO_GAMERESULT) {
+        return;
+    }
+
+    this->sprt.addResult(firstResult);
+    this->sprt.addResult(secondResult);
+
+    std::printf("Score of %s vs %s: %llu - %llu - %llu [%.3f] %llu\n", this->engines[0].name.c_str(), this->engines[1].name.c_str(),
+        static_cast<unsigned long long>(this->sprt.getWins()), static_cast<unsigned long long>(this->sprt.getLosses()),
+        static_cast<unsigned long long>(this->sprt.getDraws()), this->sprt.getScore(), static_cast<unsigned long long>(this->sprt.getGameCount()));
+    std::printf("Elo difference: %.1f +/- %.1f, LOS: %.1f %%\n", this->sprt.getElo(), this->sprt.getEloMargin(), 100.0 * this->sprt.getLos());
+    std::printf("SPRT: llr %.3f, lbound %.3f, ubound %.3f\n", this->sprt.getLlr(), this->sprt.getLowerBound(), this->sprt.getUpperBound());
+
+    if (this->sprt.getResult() != SprtResult::SPRT_CONTINUE) {
+        this->isFinished = true;
+    }
+}
+
+bool ChessMatch::loadOpenings(const std::string& fileName)
+{
+    std::ifstream openingFile(fileName);
+
+    if (!openingFile.is_open()) {
+        return false;
+    }
+
+    //EPD lines start with the first four fields of a FEN, and may carry operations after them
+    std::string line;
+
+    while (std::getline(openingFile, line)) {
+        std::stringstream ss(line);
+        std::string pieces, sideToMove, castleRights, enPassant;
+
+        if (ss >> pieces >> sideToMove >> castleRights >> enPassant) {
+            this->openings.push_back(pieces + " " + sideToMove + " " + castleRights + " " + enPassant + " 0 1");
+        }
+    }
+
+    std::shuffle(this->openings.begin(), this->openings.end(), std::mt19937(std::random_device{}()));
+
+    return !this->openings.empty();
+}
+
+TwoPlayerGameResult ChessMatch::playGame(const std::string& opening, std::uint32_t whiteEngine, ChessSearcher* searchers[2])
+{
+    const ChessBoardMover boardMover;
+
+    Clock clock;
+    clock.setClockNodes(this->settings.nodesPerMove);
+
+    ChessBoard board;
+    board.resetSpecificPosition(opening);
+
+    for (std::uint32_t engine = 0; engine < 2; engine++) {
+        searchers[engine]->resetHashtable();
+        searchers[engine]->resetMoveHistory();
+    }
+
+    for (std::uint32_t ply = 0; ; ply++) {
+        const std::uint32_t engine = board.sideToMove == Color::WHITE ? whiteEngine : 1 - whiteEngine;
+
+        //1) Mates, stalemates, draws by rule and tablebase positions end the game
+        TwoPlayerGameResult result = searchers[engine]->checkBoardGameResult(board, true, true);
+        TablebaseWdl wdl;
+
+        if (result == TwoPlayerGameResult::NO_GAMERESULT) {
+            if (ply >= this->settings.maxPlies) {
+                result = TwoPlayerGameResult::DRAW;
+            }
+            else if (ProbeTablebaseWdl(board, wdl)) {
+                result = wdl == TABLEBASE_WIN ? TwoPlayerGameResult::WIN
+                    : (wdl == TABLEBASE_LOSS ? TwoPlayerGameResult::LOSS : TwoPlayerGameResult::DRAW);
+            }
+        }
+
+        if (result != TwoPlayerGameResult::NO_GAMERESULT) {
+            return engine == 0 ? result : -result;
+        }
+
+        //2) Each engine searches with the material and piece square scores of its own parameters
+        const EvalParameters& evalParameters = *this->engines[engine].evalParameters;
+
+        ChessBoard searchBoard = board;
+        searchBoard.materialEvaluation = searchBoard.calculateMaterialEvaluation(evalParameters);
+        searchBoard.pstEvaluation = searchBoard.calculatePstEvaluation(evalParameters);
+
+        ChessPrincipalVariation principalVariation;
+
+        searchers[engine]->setClock(clock);
+        searchers[engine]->iterativeDeepeningLoop(searchBoard, principalVariation);
+
+        if (principalVariation.size() == 0) {
+            return TwoPlayerGameResult::NO_GAMERESULT;
+        }
+
+        //3) Both engines need the game's history to see repetitions
+        ChessMove move = principalVariation[0];
+        boardMover.dispatchDoMove(board, move);
+
+        for (std::uint32_t i = 0; i < 2; i++) {
+            searchers[i]->addMoveToHistory(board, move);
+        }
+    }
+}
+
+void ChessMatch::playGames()
+{
+    //Searchers are kept for every game the thread plays, so their hashtables are only cleared between games
+    std::unique_ptr<ChessSearcher> searcherList[2] = { std::make_unique<ChessSearcher>(), std::make_unique<ChessSearcher>() };
+    ChessSearcher* searchers[2] = { searcherList[0].get(), searcherList[1].get() };
+
+    for (std::uint32_t engine = 0; engine < 2; engine++) {
+        searchers[engine]->setEvalParameters(this->engines[engine].evalParameters.get());
+    }
+
+    while (!this->isFinished) {
+        const std::uint64_t gamePair = this->nextGamePair++;
+
+        if (gamePair >= this->settings.maxGamePairs) {
+            break;
+        }
+
+        //The first engine plays the opening with white, then with black
+        const std::string& opening = this->openings[gamePair % this->openings.size()];
+
+        const TwoPlayerGameResult firstResult = this->playGame(opening, 0, searchers);
+        const TwoPlayerGameResult secondResult = this->playGame(opening, 1, searchers);
+
+        this->addGamePair(firstResult, secondResult);
+    }
+}
+
+SprtResult ChessMatch::play()
+{
+    this->sprt = Sprt(this->settings.sprt);
+
+    this->nextGamePair = 0;
+    this->isFinished = false;
+
+    if (this->openings.empty()) {
+        ChessBoard board;
+        board.resetStartingPosition();
+
+        this->openings.push_back(board.saveToFen());
+    }
+
+    //Each thread plays whole game pairs with its own searchers
+    for (std::uint32_t i = 0; i < this->threadPool.size(); i++) {
+        this->threadPool.submit([this]() { this->playGames(); });
+    }
+
+    this->threadPool.wait();
+
+    return this->sprt.getResult();
+}
+
+void ChessMatch::setEngine(std::uint32_t index, const MatchEngine& engine)
+{
+    this->engines[index] = engine;
+}
@@ -0,0 +1,90 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+#include "../board/board.h"
+
+#include "../eval/parameters.h"
+
+#include "../../game/math/sprt.h"
+#include "../../game/threads/threadpool.h"
+#include "../../game/types/nodecount.h"
+#include "../../game/types/result.h"
+
+class ChessSearcher;
+
+struct MatchSettings {
+    std::uint64_t maxGamePairs = 50000;
+    NodeCount nodesPerMove = 100000;
+
+    std::uint32_t maxPlies = 400;
+
+    SprtSettings sprt;
+};
+
+//One side of the match, which only differs from the other by its evaluation parameters
+struct MatchEngine {
+    std::string name;
+    std::shared_ptr<const EvalParameters> evalParameters;
+};
+
+//Plays two engines against each other in process, each opening once with either color, until the SPRT decides or the game pairs run out.
+//Search parameters are globals, so both engines share them.
+class ChessMatch
+{
+protected:
+    MatchSettings settings;
+
+    ThreadPool threadPool;
+
+    MatchEngine engines[2];
+    std::vector<std::string> openings;
+
+    std::mutex resultMutex;
+    Sprt sprt;
+
+    std::atomic<std::uint64_t> nextGamePair = 0;
+    std::atomic<bool> isFinished = false;
+
+    void addGamePair(TwoPlayerGameResult firstResult, TwoPlayerGameResult secondResult);
+
+    //The result is the first engine's
+    TwoPlayerGameResult playGame(const std::string& opening, std::uint32_t whiteEngine, ChessSearcher* searchers[2]);
+    void playGames();
+public:
+    ChessMatch(const MatchSettings& settings, std::uint32_t threadCount = 0);
+
+    bool loadOpenings(const std::string& fileName);
+    void setEngine(std::uint32_t index, const MatchEngine& engine);
+
+    SprtResult play();
+
+    const Sprt& getSprt() const
+    {
+        return this->sprt;
+    }
+};
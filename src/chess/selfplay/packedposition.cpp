@@ -0,0 +1,231 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include <cassert>
+#include <cstdlib>
+
+#include "packedposition.h"
+
+constexpr std::uint8_t BlackPieceNibble = 8;
+
+PackedPosition PackPosition(const ChessBoard& board, Score score, TwoPlayerGameResult result)
+{
+    PackedPosition packedPosition = {};
+
+    packedPosition.occupancy = board.allPieces;
+
+    //1) One nibble per occupied square, with the color above the piece type
+    std::uint32_t pieceIndex = 0;
+
+    for (const Square src : SquareBitboardIterator(board.allPieces)) {
+        assert(pieceIndex < 32);
+
+        const bool isBlackPiece = (board.blackPieces[PieceType::ALL] & OneShiftedBy(src)) != EmptyBitboard;
+        const std::uint8_t nibble = static_cast<std::uint8_t>(board.pieces[src]) | (isBlackPiece ? BlackPieceNibble : 0);
+
+        packedPosition.pieces[pieceIndex / 2] |= nibble << (4 * (pieceIndex % 2));
+        pieceIndex++;
+    }
+
+    //2) Then the rest of the state
+    packedPosition.sideToMoveAndCastleRights = (board.sideToMove == Color::WHITE ? 0 : 1) | (static_cast<std::uint8_t>(board.castleRights) << 1);
+    packedPosition.enPassant = static_cast<std::uint8_t>(board.enPassant);
+    packedPosition.fiftyMoveCount = static_cast<std::uint8_t>(std::min(board.fiftyMoveCount, NodeCount(255)));
+
+    packedPosition.result = static_cast<std::uint8_t>(result);
+    packedPosition.score = static_cast<std::int16_t>(score);
+    packedPosition.fullMoveCount = static_cast<std::uint16_t>(std::min(board.fullMoveCount, NodeCount(65535)));
+
+    return packedPosition;
+}
+
+void UnpackPosition(const PackedPosition& packedPosition, ChessBoard& board)
+{
+    board.clearEverything();
+
+    std::uint32_t pieceIndex = 0;
+
+    for (const Square src : SquareBitboardIterator(packedPosition.occupancy)) {
+        const std::uint8_t nibble = (packedPosition.pieces[pieceIndex / 2] >> (4 * (pieceIndex % 2))) & 0xf;
+
+        board.pieces[src] = PieceType(nibble & ~BlackPieceNibble);
+
+        if (nibble & BlackPieceNibble) {
+            board.blackPieces[PieceType::ALL] |= src;
+        }
+        else {
+            board.whitePieces[PieceType::ALL] |= src;
+        }
+
+        pieceIndex++;
+    }
+
+    board.sideToMove = (packedPosition.sideToMoveAndCastleRights & 1) ? Color::BLACK : Color::WHITE;
+    board.castleRights = CastleRights(packedPosition.sideToMoveAndCastleRights >> 1);
+    board.enPassant = Square(packedPosition.enPassant);
+    board.fiftyMoveCount = packedPosition.fiftyMoveCount;
+    board.fullMoveCount = packedPosition.fullMoveCount;
+
+    board.initFromMailbox();
+}
+
+bool PackedPositionWriter::open(const std::string& fileName, bool append)
+{
+    const std::ios::openmode mode = std::ios::out | std::ios::binary | (append ? std::ios::app : std::ios::trunc);
+
+    this->positionFile.open(fileName, mode);
+
+    return this->positionFile.is_open();
+}
+
+bool PackedPositionWriter::close()
+{
+    this->positionFile.close();
+
+    return static_cast<bool>(this->positionFile);
+}
+
+bool PackedPositionWriter::write(const PackedPosition& packedPosition)
+{
+    this->positionFile.write(reinterpret_cast<const char*>(&packedPosition), sizeof(PackedPosition));
+
+    return static_cast<bool>(this->positionFile);
+}
+
+bool PackedPositionReader::open(const std::string& fileName)
+{
+    this->close();
+
+    if (!this->positionFile.open(fileName)) {
+        return false;
+    }
+
+    if (this->positionFile.getSize() % sizeof(PackedPosition) != 0) {
+        this->positionFile.close();
+        return false;
+    }
+
+    this->positions = reinterpret_cast<const PackedPosition*>(this->positionFile.getData());
+    this->positionCount = this->positionFile.getSize() / sizeof(PackedPosition);
+
+    return true;
+}
+
+void PackedPositionReader::close()
+{
+    this->positionFile.close();
+
+    this->positions = nullptr;
+    this->positionCount = 0;
+}
+
+bool PackPositionFile(const std::string& positionFileName, const std::string& packedFileName, std::uint64_t& positionCount)
+{
+    std::ifstream positionFile(positionFileName);
+    PackedPositionWriter writer;
+
+    positionCount = 0;
+
+    if (!positionFile || !writer.open(packedFileName)) {
+        return false;
+    }
+
+    std::string line;
+
+    //epoch,random,fen,result,depth,score,nodecount,principal variation
+    while (std::getline(positionFile, line)) {
+        std::stringstream ss(line);
+        std::string epoch, random, fen, resultText, depth, scoreText;
+
+        if (!std::getline(ss, epoch, ',') || !std::getline(ss, random, ',') || !std::getline(ss, fen, ',')
+            || !std::getline(ss, resultText, ',') || !std::getline(ss, depth, ',') || !std::getline(ss, scoreText, ',')) {
+            continue;
+        }
+
+        TwoPlayerGameResult result;
+
+        if (resultText == "1.0") {
+            result = TwoPlayerGameResult::WIN;
+        }
+        else if (resultText == "0.5") {
+            result = TwoPlayerGameResult::DRAW;
+        }
+        else if (resultText == "0.0") {
+            result = TwoPlayerGameResult::LOSS;
+        }
+        else {
+            continue;
+        }
+
+        char* scoreEnd;
+        const long score = std::strtol(scoreText.c_str(), &scoreEnd, 10);
+
+        if (scoreEnd == scoreText.c_str()) {
+            continue;
+        }
+
+        ChessBoard board;
+        board.resetSpecificPosition(fen);
+
+        if (!writer.write(PackPosition(board, Score(score), result))) {
+            return false;
+        }
+
+        positionCount++;
+    }
+
+    return writer.close();
+}
+
+bool UnpackPositionFile(const std::string& packedFileName, const std::string& positionFileName, std::uint64_t& positionCount)
+{
+    PackedPositionReader reader;
+    std::ofstream positionFile(positionFileName, std::ios::out | std::ios::trunc);
+
+    positionCount = 0;
+
+    if (!reader.open(packedFileName) || !positionFile) {
+        return false;
+    }
+
+    static const char* ResultText[] = { "0.0", "0.5", "1.0" };
+
+    //The packed format has no epoch, depth, node count or principal variation, so they're left empty
+    for (const PackedPosition& packedPosition : reader) {
+        if (packedPosition.result > TwoPlayerGameResult::WIN) {
+            continue;
+        }
+
+        ChessBoard board;
+        UnpackPosition(packedPosition, board);
+
+        positionFile << "0x" << std::hex << std::setw(16) << std::setfill('0') << 0 << ','
+            << "0x" << std::setw(16) << 0 << std::dec << ',' << board.saveToFen() << ',' << ResultText[packedPosition.result] << ','
+            << 0 << ',' << packedPosition.score << ',' << 0 << ',' << '\n';
+
+        positionCount++;
+    }
+
+    positionFile.close();
+
+    return static_cast<bool>(positionFile);
+}
@@ -0,0 +1,99 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <fstream>
+#include <string>
+
+#include <cstdint>
+
+#include "../board/board.h"
+
+#include "../../game/io/mappedfile.h"
+#include "../../game/types/result.h"
+#include "../../game/types/score.h"
+
+//A position in 32 bytes: the occupied squares, then a piece nibble for each of them in square order
+struct PackedPosition {
+    Bitboard occupancy;
+    std::uint8_t pieces[16];
+
+    //Side to move in the low bit, castle rights above it
+    std::uint8_t sideToMoveAndCastleRights;
+    std::uint8_t enPassant;
+    std::uint8_t fiftyMoveCount;
+
+    //Score and result are both from the side to move's point of view
+    std::uint8_t result;
+    std::int16_t score;
+    std::uint16_t fullMoveCount;
+};
+
+static_assert(sizeof(PackedPosition) == 32);
+
+PackedPosition PackPosition(const ChessBoard& board, Score score, TwoPlayerGameResult result);
+void UnpackPosition(const PackedPosition& packedPosition, ChessBoard& board);
+
+class PackedPositionWriter
+{
+protected:
+    std::ofstream positionFile;
+public:
+    bool open(const std::string& fileName, bool append = false);
+    bool close();
+
+    bool write(const PackedPosition& packedPosition);
+};
+
+//Maps a packed position file so it can be scanned in place
+class PackedPositionReader
+{
+protected:
+    MappedFile positionFile;
+
+    const PackedPosition* positions = nullptr;
+    std::size_t positionCount = 0;
+public:
+    bool open(const std::string& fileName);
+    void close();
+
+    const PackedPosition* begin() const
+    {
+        return this->positions;
+    }
+
+    const PackedPosition* end() const
+    {
+        return this->positions + this->positionCount;
+    }
+
+    const PackedPosition& operator [](std::size_t index) const
+    {
+        return this->positions[index];
+    }
+
+    std::size_t size() const
+    {
+        return this->positionCount;
+    }
+};
+
+//Converts between packed files and the lines of data/positions.txt, which also carry what the packed format drops
+bool PackPositionFile(const std::string& positionFileName, const std::string& packedFileName, std::uint64_t& positionCount);
+bool UnpackPositionFile(const std::string& packedFileName, const std::string& positionFileName, std::uint64_t& positionCount);
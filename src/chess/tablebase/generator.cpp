@@ -0,0 +1,586 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+
+#include "generator.h"
+
+#include "../board/attackgenerator.h"
+#include "../board/boardmover.h"
+#include "../board/movegenerator.h"
+
+#include "../bitboards/magics.h"
+#include "../bitboards/moves.h"
+
+#include "../types/direction.h"
+
+//Generation results extend the probed ones with positions that aren't decided yet
+constexpr std::uint8_t TABLEBASE_UNKNOWN = 4;
+
+//A position with a drawing capture or promotion can't lose, so it doesn't need to count its moves
+constexpr std::uint8_t CannotLoseCounter = 0xff;
+
+constexpr std::uint16_t NoDistance = 0xffff;
+
+constexpr std::uint64_t GeneratorChunkSize = 1 << 14;
+
+static Bitboard GetPieceAttacks(PieceType pieceType, Square src, Bitboard allPieces)
+{
+    switch (pieceType) {
+    case PieceType::BISHOP:
+        return BishopMagic(src, allPieces);
+    case PieceType::ROOK:
+        return RookMagic(src, allPieces);
+    case PieceType::QUEEN:
+        return QueenMagic(src, allPieces);
+    default:
+        return PieceMoves[pieceType][src];
+    }
+}
+
+static void SortAndRemoveDuplicates(std::vector<std::uint64_t>& indexes)
+{
+    std::sort(indexes.begin(), indexes.end());
+    indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+}
+
+//Every position one move before this one that stays in the table, optionally without pawn moves since they don't count towards DTZ
+static void GetPredecessors(const TablebaseMaterial& material, std::uint64_t index, bool includePawnMoves, std::vector<std::uint64_t>& predecessors)
+{
+    Color sideToMove;
+    TablebaseSquares squares;
+
+    material.getPosition(index, sideToMove, squares);
+
+    const Color movedSide = ~sideToMove;
+
+    Bitboard allPieces = EmptyBitboard;
+
+    for (std::uint32_t i = 0; i < material.pieceCount; i++) {
+        allPieces |= squares[i];
+    }
+
+    predecessors.clear();
+
+    for (std::uint32_t i = 0; i < material.pieceCount; i++) {
+        if (material.colors[i] != movedSide) {
+            continue;
+        }
+
+        const Square dst = squares[i];
+
+        //1) Pieces come back from any empty square they attack
+        if (material.pieces[i] != PieceType::PAWN) {
+            const Bitboard srcSquares = GetPieceAttacks(material.pieces[i], dst, allPieces) & ~allPieces;
+
+            for (const Square src : SquareBitboardIterator(srcSquares)) {
+                squares[i] = src;
+                predecessors.push_back(material.getIndex(movedSide, squares));
+            }
+
+            squares[i] = dst;
+            continue;
+        }
+
+        if (!includePawnMoves) {
+            continue;
+        }
+
+        //2) Pawns go back one square, or two from their fourth rank, but never onto the back rank
+        const Direction backward = movedSide == Color::WHITE ? Direction::DOWN : Direction::UP;
+        const Rank doublePushRank = movedSide == Color::WHITE ? Rank::_4 : Rank::_5;
+        const Rank backRank = movedSide == Color::WHITE ? Rank::_1 : Rank::_8;
+
+        const Square singleSrc = dst + backward;
+
+        if ((allPieces & singleSrc) != EmptyBitboard || GetRank(singleSrc) == backRank) {
+            continue;
+        }
+
+        squares[i] = singleSrc;
+        predecessors.push_back(material.getIndex(movedSide, squares));
+
+        if (GetRank(dst) == doublePushRank
+            && (allPieces & (singleSrc + backward)) == EmptyBitboard) {
+            squares[i] = singleSrc + backward;
+            predecessors.push_back(material.getIndex(movedSide, squares));
+        }
+
+        squares[i] = dst;
+    }
+
+    SortAndRemoveDuplicates(predecessors);
+}
+
+//Sets up the board for an index, or returns false if the index isn't a legal position in its one canonical form
+static bool SetupTablebaseBoard(const TablebaseMaterial& material, std::uint64_t index, ChessBoard& board)
+{
+    const ChessAttackGenerator attackGenerator;
+
+    Color sideToMove;
+    TablebaseSquares squares;
+
+    material.getPosition(index, sideToMove, squares);
+
+    //1) Overlapping pieces and touching kings
+    Bitboard allPieces = EmptyBitboard;
+
+    for (std::uint32_t i = 0; i < material.pieceCount; i++) {
+        if ((allPieces & squares[i]) != EmptyBitboard) {
+            return false;
+        }
+
+        allPieces |= squares[i];
+    }
+
+    if ((PieceMoves[PieceType::KING][squares[0]] & squares[1]) != EmptyBitboard) {
+        return false;
+    }
+
+    //2) Mirrored or reordered copies of a position are only stored once
+    if (material.getIndex(sideToMove, squares) != index) {
+        return false;
+    }
+
+    //3) The side that just moved can't be left in check
+    material.setupBoard(board, sideToMove, squares);
+
+    return sideToMove == Color::WHITE
+        ? !attackGenerator.isInCheck<false>(board)
+        : !attackGenerator.isInCheck<true>(board);
+}
+
+static bool IsZeroingMove(const ChessBoard& board, const ChessMove& move)
+{
+    return board.pieceAt(move.src) == PieceType::PAWN || board.pieceAt(move.dst) != PieceType::NO_PIECE;
+}
+
+static bool IsConversionMove(const ChessBoard& board, const ChessMove& move)
+{
+    return board.pieceAt(move.dst) != PieceType::NO_PIECE || move.promotionPiece != PieceType::NO_PIECE;
+}
+
+TablebaseGenerator::TablebaseGenerator(const std::string& directory, std::uint32_t threadCount) : threadPool(threadCount), directory(directory)
+{
+}
+
+std::vector<std::uint64_t> TablebaseGenerator::initializeResults(const TablebaseMaterial& material)
+{
+    std::vector<std::uint64_t> frontier;
+    std::mutex frontierMutex;
+
+    this->threadPool.parallelFor(material.positionCount, GeneratorChunkSize, [&](std::uint64_t first, std::uint64_t last) {
+        const ChessAttackGenerator attackGenerator;
+        const ChessBoardMover boardMover;
+        const ChessMoveGenerator moveGenerator;
+
+        ChessBoard board, nextBoard;
+        ChessMoveList moveList;
+
+        std::vector<std::uint64_t> successors, decided;
+
+        for (std::uint64_t index = first; index < last; index++) {
+            std::uint8_t& result = this->results[index];
+
+            if (!SetupTablebaseBoard(material, index, board)) {
+                result = TABLEBASE_BROKEN;
+                continue;
+            }
+
+            //1) Mate and stalemate
+            if (moveGenerator.DispatchGenerateAllMoves(board, moveList) == ZeroNodes) {
+                result = attackGenerator.dispatchIsInCheck(board) ? TABLEBASE_LOSS : TABLEBASE_DRAW;
+
+                if (result == TABLEBASE_LOSS) {
+                    decided.push_back(index);
+                }
+
+                continue;
+            }
+
+            //2) Captures and promotions are looked up in the smaller tables, while other moves are counted
+            bool canDraw = false;
+
+            result = TABLEBASE_UNKNOWN;
+            successors.clear();
+
+            for (ChessMove& move : moveList) {
+                const bool isConversion = IsConversionMove(board, move);
+
+                nextBoard = board;
+                boardMover.dispatchDoMove(nextBoard, move);
+
+                if (isConversion) {
+                    TablebaseWdl wdl = TABLEBASE_DRAW;
+                    ProbeTablebaseWdl(nextBoard, wdl);
+
+                    if (wdl == TABLEBASE_LOSS) {
+                        result = TABLEBASE_WIN;
+                        break;
+                    }
+
+                    canDraw = canDraw || wdl == TABLEBASE_DRAW;
+                }
+                else {
+                    Color sideToMove;
+                    TablebaseSquares squares;
+
+                    material.getSquaresFromBoard(nextBoard, false, sideToMove, squares);
+                    successors.push_back(material.getIndex(sideToMove, squares));
+                }
+            }
+
+            if (result == TABLEBASE_WIN) {
+                decided.push_back(index);
+                continue;
+            }
+
+            SortAndRemoveDuplicates(successors);
+
+            //3) Nothing left in the table means every move was a capture or promotion
+            if (successors.empty()) {
+                result = canDraw ? TABLEBASE_DRAW : TABLEBASE_LOSS;
+
+                if (result == TABLEBASE_LOSS) {
+                    decided.push_back(index);
+                }
+
+                continue;
+            }
+
+            this->counters[index] = canDraw ? CannotLoseCounter : static_cast<std::uint8_t>(successors.size());
+        }
+
+        std::lock_guard<std::mutex> lock(frontierMutex);
+        frontier.insert(frontier.end(), decided.begin(), decided.end());
+    });
+
+    return frontier;
+}
+
+void TablebaseGenerator::propagateResults(const TablebaseMaterial& material, std::vector<std::uint64_t> frontier)
+{
+    //Every position before a loss is a win, and a position whose moves all lead to wins is a loss
+    while (!frontier.empty()) {
+        std::vector<std::uint64_t> nextFrontier;
+        std::mutex frontierMutex;
+
+        this->threadPool.parallelFor(frontier.size(), GeneratorChunkSize / 16, [&](std::uint64_t first, std::uint64_t last) {
+            std::vector<std::uint64_t> predecessors, decided;
+
+            for (std::uint64_t i = first; i < last; i++) {
+                const std::uint64_t index = frontier[i];
+                const bool isLoss = this->results[index] == TABLEBASE_LOSS;
+
+                GetPredecessors(material, index, true, predecessors);
+
+                for (const std::uint64_t predecessor : predecessors) {
+                    std::atomic_ref<std::uint8_t> result(this->results[predecessor]);
+                    std::uint8_t unknown = TABLEBASE_UNKNOWN;
+
+                    if (result.load(std::memory_order_relaxed) != TABLEBASE_UNKNOWN) {
+                        continue;
+                    }
+
+                    if (isLoss) {
+                        if (result.compare_exchange_strong(unknown, TABLEBASE_WIN)) {
+                            decided.push_back(predecessor);
+                        }
+
+                        continue;
+                    }
+
+                    std::atomic_ref<std::uint8_t> counter(this->counters[predecessor]);
+
+                    if (counter.load(std::memory_order_relaxed) != CannotLoseCounter
+                        && counter.fetch_sub(1) == 1
+                        && result.compare_exchange_strong(unknown, TABLEBASE_LOSS)) {
+                        decided.push_back(predecessor);
+                    }
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(frontierMutex);
+            nextFrontier.insert(nextFrontier.end(), decided.begin(), decided.end());
+        });
+
+        frontier.swap(nextFrontier);
+    }
+
+    //Anything left can be held forever
+    for (std::uint8_t& result : this->results) {
+        if (result == TABLEBASE_UNKNOWN) {
+            result = TABLEBASE_DRAW;
+        }
+    }
+}
+
+std::vector<std::vector<std::uint64_t>> TablebaseGenerator::initializeDistances(const TablebaseMaterial& material)
+{
+    std::vector<std::vector<std::uint64_t>> levels(2);
+    std::mutex levelMutex;
+
+    this->distances.assign(material.positionCount, NoDistance);
+
+    this->threadPool.parallelFor(material.positionCount, GeneratorChunkSize, [&](std::uint64_t first, std::uint64_t last) {
+        const ChessBoardMover boardMover;
+        const ChessMoveGenerator moveGenerator;
+
+        ChessBoard board, nextBoard;
+        ChessMoveList moveList;
+
+        std::vector<std::uint64_t> successors;
+        std::array<std::vector<std::uint64_t>, 2> decided;
+
+        for (std::uint64_t index = first; index < last; index++) {
+            const std::uint8_t result = this->results[index];
+
+            if (result != TABLEBASE_WIN && result != TABLEBASE_LOSS) {
+                continue;
+            }
+
+            SetupTablebaseBoard(material, index, board);
+
+            if (moveGenerator.DispatchGenerateAllMoves(board, moveList) == ZeroNodes) {
+                this->distances[index] = 0;
+                decided[0].push_back(index);
+
+                continue;
+            }
+
+            successors.clear();
+
+            for (ChessMove& move : moveList) {
+                const bool isZeroing = IsZeroingMove(board, move);
+                const bool isConversion = IsConversionMove(board, move);
+
+                //1) A winner only cares about zeroing moves, a loser only about the others
+                if ((result == TABLEBASE_WIN) != isZeroing) {
+                    continue;
+                }
+
+                nextBoard = board;
+                boardMover.dispatchDoMove(nextBoard, move);
+
+                Color sideToMove;
+                TablebaseSquares squares;
+                TablebaseWdl wdl = TABLEBASE_DRAW;
+
+                if (isConversion) {
+                    ProbeTablebaseWdl(nextBoard, wdl);
+                }
+                else {
+                    material.getSquaresFromBoard(nextBoard, false, sideToMove, squares);
+                    successors.push_back(material.getIndex(sideToMove, squares));
+
+                    wdl = TablebaseWdl(this->results[successors.back()]);
+                }
+
+                //2) A winner that can capture or push a pawn into a lost position is one ply from zeroing
+                if (result == TABLEBASE_WIN && wdl == TABLEBASE_LOSS) {
+                    this->distances[index] = 1;
+                    break;
+                }
+            }
+
+            if (result == TABLEBASE_LOSS) {
+                SortAndRemoveDuplicates(successors);
+
+                if (successors.empty()) {
+                    this->distances[index] = 1;
+                }
+                else {
+                    this->counters[index] = static_cast<std::uint8_t>(successors.size());
+                }
+            }
+
+            if (this->distances[index] == 1) {
+                decided[1].push_back(index);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(levelMutex);
+
+        for (std::size_t level = 0; level < decided.size(); level++) {
+            levels[level].insert(levels[level].end(), decided[level].begin(), decided[level].end());
+        }
+    });
+
+    return levels;
+}
+
+void TablebaseGenerator::propagateDistances(const TablebaseMaterial& material, std::vector<std::vector<std::uint64_t>> levels)
+{
+    //The winner takes the quickest way to zero, the loser the slowest, one ply at a time
+    for (std::uint16_t distance = 0; distance < levels.size(); distance++) {
+        const std::vector<std::uint64_t>& frontier = levels[distance];
+
+        std::vector<std::uint64_t> nextFrontier;
+        std::mutex frontierMutex;
+
+        this->threadPool.parallelFor(frontier.size(), GeneratorChunkSize / 16, [&](std::uint64_t first, std::uint64_t last) {
+            std::vector<std::uint64_t> predecessors, decided;
+
+            for (std::uint64_t i = first; i < last; i++) {
+                const std::uint64_t index = frontier[i];
+                const bool isLoss = this->results[index] == TABLEBASE_LOSS;
+
+                GetPredecessors(material, index, false, predecessors);
+
+                for (const std::uint64_t predecessor : predecessors) {
+                    std::atomic_ref<std::uint16_t> predecessorDistance(this->distances[predecessor]);
+                    std::uint16_t noDistance = NoDistance;
+
+                    if (predecessorDistance.load(std::memory_order_relaxed) != NoDistance
+                        || this->results[predecessor] != (isLoss ? TABLEBASE_WIN : TABLEBASE_LOSS)) {
+                        continue;
+                    }
+
+                    if (isLoss) {
+                        if (predecessorDistance.compare_exchange_strong(noDistance, distance + 1)) {
+                            decided.push_back(predecessor);
+                        }
+
+                        continue;
+                    }
+
+                    std::atomic_ref<std::uint8_t> counter(this->counters[predecessor]);
+
+                    if (counter.fetch_sub(1) == 1
+                        && predecessorDistance.compare_exchange_strong(noDistance, distance + 1)) {
+                        decided.push_back(predecessor);
+                    }
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(frontierMutex);
+            nextFrontier.insert(nextFrontier.end(), decided.begin(), decided.end());
+        });
+
+        if (nextFrontier.empty()) {
+            continue;
+        }
+
+        if (levels.size() <= std::size_t(distance) + 1) {
+            levels.emplace_back();
+        }
+
+        levels[distance + 1].insert(levels[distance + 1].end(), nextFrontier.begin(), nextFrontier.end());
+    }
+}
+
+bool TablebaseGenerator::generateTable(const TablebaseMaterial& material)
+{
+    const std::string name = material.getName();
+    const auto startTime = std::chrono::steady_clock::now();
+
+    //1) Every capture and promotion has to land in a table that's already there
+    for (const TablebaseMaterial& dependency : GetTablebaseMaterialDependencies(material)) {
+        Tablebase* dependencyTablebase = FindTablebase(dependency);
+
+        if (dependency.getName() != name && (dependencyTablebase == nullptr || !dependencyTablebase->isAvailable())) {
+            std::cout << "Tablebase " << name << " needs " << dependency.getName() << std::endl;
+            return false;
+        }
+    }
+
+    this->results.assign(material.positionCount, TABLEBASE_UNKNOWN);
+    this->counters.assign(material.positionCount, 0);
+
+    //2) Win, draw or loss, working back from mates and conversions
+    this->propagateResults(material, this->initializeResults(material));
+
+    //3) Then the distance to zeroing for everything that isn't drawn
+    this->propagateDistances(material, this->initializeDistances(material));
+
+    std::unique_ptr<Tablebase> tablebase = std::make_unique<Tablebase>(material);
+    std::array<std::uint64_t, 4> resultCounts = {};
+    std::uint32_t maxDistance = 0;
+
+    for (std::uint64_t index = 0; index < material.positionCount; index++) {
+        const TablebaseWdl wdl = TablebaseWdl(this->results[index]);
+        const std::uint32_t distance = wdl == TABLEBASE_WIN || wdl == TABLEBASE_LOSS ? this->distances[index] : 0;
+
+        tablebase->setWdl(index, wdl);
+        tablebase->setDtz(index, distance);
+
+        resultCounts[wdl]++;
+        maxDistance = std::max(maxDistance, wdl == TABLEBASE_BROKEN ? 0 : distance);
+    }
+
+    this->results = {};
+    this->counters = {};
+    this->distances = {};
+
+    //4) Save it and make it available to the tables built on top of it
+    std::error_code error;
+    std::filesystem::create_directories(this->directory, error);
+
+    if (!tablebase->save(GetTablebaseFileName(this->directory, material))) {
+        std::cout << "Unable to save tablebase " << GetTablebaseFileName(this->directory, material) << std::endl;
+    }
+
+    AddTablebase(std::move(tablebase));
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+
+    std::cout << name << ": " << resultCounts[TABLEBASE_WIN] << " wins, " << resultCounts[TABLEBASE_DRAW] << " draws, " << resultCounts[TABLEBASE_LOSS] << " losses, "
+        << "max dtz " << maxDistance << ", " << elapsed.count() << " ms" << std::endl;
+
+    return true;
+}
+
+bool TablebaseGenerator::generateTables(const std::vector<TablebaseMaterial>& materials)
+{
+    for (const TablebaseMaterial& material : materials) {
+        Tablebase* existingTablebase = FindTablebase(material);
+
+        if (existingTablebase != nullptr && existingTablebase->isAvailable()) {
+            continue;
+        }
+
+        //Tables left over from an earlier run are reused
+        std::unique_ptr<Tablebase> tablebase = std::make_unique<Tablebase>(material, GetTablebaseFileName(this->directory, material));
+
+        if (tablebase->isAvailable()) {
+            AddTablebase(std::move(tablebase));
+            continue;
+        }
+
+        if (!this->generateTable(material)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TablebaseGenerator::generate(const TablebaseMaterial& material)
+{
+    return this->generateTables(GetTablebaseMaterialDependencies(material));
+}
+
+bool TablebaseGenerator::generateAll(std::uint32_t maxPieceCount)
+{
+    return this->generateTables(GetTablebaseMaterials(maxPieceCount));
+}
@@ -0,0 +1,54 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+#include "tablebase.h"
+#include "tbindex.h"
+
+#include "../../game/threads/threadpool.h"
+
+class TablebaseGenerator
+{
+protected:
+    ThreadPool threadPool;
+    std::string directory;
+
+    std::vector<std::uint8_t> results;
+    std::vector<std::uint8_t> counters;
+    std::vector<std::uint16_t> distances;
+
+    std::vector<std::uint64_t> initializeResults(const TablebaseMaterial& material);
+    void propagateResults(const TablebaseMaterial& material, std::vector<std::uint64_t> frontier);
+
+    std::vector<std::vector<std::uint64_t>> initializeDistances(const TablebaseMaterial& material);
+    void propagateDistances(const TablebaseMaterial& material, std::vector<std::vector<std::uint64_t>> levels);
+
+    bool generateTable(const TablebaseMaterial& material);
+    bool generateTables(const std::vector<TablebaseMaterial>& materials);
+public:
+    explicit TablebaseGenerator(const std::string& directory, std::uint32_t threadCount = 0);
+
+    bool generate(const TablebaseMaterial& material);
+    bool generateAll(std::uint32_t maxPieceCount);
+};
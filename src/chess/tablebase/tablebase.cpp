@@ -0,0 +1,344 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+#include <cstring>
+
+#include "tablebase.h"
+
+#include "../board/boardmover.h"
+
+#include "../types/castlerights.h"
+
+static const char TablebaseMagic[4] = { 'J', 'W', 'T', 'B' };
+static constexpr std::uint32_t TablebaseVersion = 1;
+
+static const std::string TablebaseExtension = ".jwtb";
+
+static constexpr std::size_t TablebaseHeaderSize = sizeof(TablebaseMagic) + 2 * sizeof(std::uint32_t) + sizeof(std::uint64_t);
+
+struct TablebaseEntry {
+    Tablebase* tablebase;
+    bool flipped;
+};
+
+static std::vector<std::unique_ptr<Tablebase>> Tablebases;
+static std::unordered_map<Hash, TablebaseEntry> TablebaseEntries;
+
+static std::uint32_t TablebasePieceCount = 0;
+static std::uint32_t TablebaseProbePieceLimit = TablebaseMaxPieces;
+
+std::uint32_t TablebaseProbePieceCount = 0;
+Depth TablebaseProbeDepth = Depth::ZERO;
+
+Tablebase::Tablebase(const TablebaseMaterial& material) : material(material)
+{
+    this->generatedData.resize((material.positionCount + 3) / 4 + material.positionCount);
+
+    this->wdlData = this->generatedData.data();
+    this->dtzData = this->wdlData + (material.positionCount + 3) / 4;
+
+    this->state.store(TABLEBASE_LOADED, std::memory_order_release);
+}
+
+Tablebase::Tablebase(const TablebaseMaterial& material, const std::string& fileName) : material(material), fileName(fileName)
+{
+}
+
+bool Tablebase::load()
+{
+    std::lock_guard<std::mutex> lock(this->loadMutex);
+
+    //1) Another thread may have mapped it while this one waited
+    const TablebaseState currentState = this->state.load(std::memory_order_acquire);
+
+    if (currentState != TABLEBASE_UNLOADED) {
+        return currentState == TABLEBASE_LOADED;
+    }
+
+    //2) Check the header matches the table the name says it is
+    const std::string name = this->material.getName();
+    const std::uint64_t wdlSize = (this->material.positionCount + 3) / 4;
+    const std::uint64_t expectedSize = TablebaseHeaderSize + name.size() + wdlSize + this->material.positionCount;
+
+    bool isValid = this->mappedFile.open(this->fileName) && this->mappedFile.getSize() == expectedSize;
+
+    if (isValid) {
+        const std::uint8_t* header = this->mappedFile.getData();
+
+        std::uint32_t version, nameLength;
+        std::uint64_t positionCount;
+
+        std::memcpy(&version, header + sizeof(TablebaseMagic), sizeof(version));
+        std::memcpy(&nameLength, header + sizeof(TablebaseMagic) + sizeof(version), sizeof(nameLength));
+        std::memcpy(&positionCount, header + TablebaseHeaderSize - sizeof(positionCount) + name.size(), sizeof(positionCount));
+
+        isValid = std::equal(TablebaseMagic, TablebaseMagic + sizeof(TablebaseMagic), header)
+            && version == TablebaseVersion
+            && nameLength == name.size()
+            && std::equal(name.begin(), name.end(), header + TablebaseHeaderSize - sizeof(positionCount))
+            && positionCount == this->material.positionCount;
+    }
+
+    if (!isValid) {
+        std::cout << "Unable to load tablebase " << this->fileName << std::endl;
+
+        this->mappedFile.close();
+        this->state.store(TABLEBASE_FAILED, std::memory_order_release);
+
+        return false;
+    }
+
+    //3) The packed results and the distances follow the header
+    this->wdlData = this->mappedFile.getData() + TablebaseHeaderSize + name.size();
+    this->dtzData = this->wdlData + wdlSize;
+
+    this->state.store(TABLEBASE_LOADED, std::memory_order_release);
+
+    return true;
+}
+
+bool Tablebase::save(const std::string& fileName) const
+{
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+
+    const std::string name = this->material.getName();
+    const std::uint32_t nameLength = static_cast<std::uint32_t>(name.size());
+
+    file.write(TablebaseMagic, sizeof(TablebaseMagic));
+    file.write(reinterpret_cast<const char*>(&TablebaseVersion), sizeof(TablebaseVersion));
+    file.write(reinterpret_cast<const char*>(&nameLength), sizeof(nameLength));
+    file.write(name.data(), nameLength);
+    file.write(reinterpret_cast<const char*>(&this->material.positionCount), sizeof(this->material.positionCount));
+
+    file.write(reinterpret_cast<const char*>(this->generatedData.data()), this->generatedData.size());
+
+    return static_cast<bool>(file);
+}
+
+std::string GetTablebaseFileName(const std::string& directory, const TablebaseMaterial& material)
+{
+    return (std::filesystem::path(directory) / (material.getName() + TablebaseExtension)).string();
+}
+
+void AddTablebase(std::unique_ptr<Tablebase> tablebase)
+{
+    const TablebaseMaterial& material = tablebase->getMaterial();
+
+    //The same table answers for the material with the colors swapped
+    TablebaseEntries[material.getMaterialHash(true)] = { tablebase.get(), true };
+    TablebaseEntries[material.getMaterialHash(false)] = { tablebase.get(), false };
+
+    TablebasePieceCount = std::max(TablebasePieceCount, material.pieceCount);
+    TablebaseProbePieceCount = std::min(TablebasePieceCount, TablebaseProbePieceLimit);
+
+    Tablebases.push_back(std::move(tablebase));
+}
+
+void ClearTablebases()
+{
+    TablebaseEntries.clear();
+    Tablebases.clear();
+
+    TablebasePieceCount = 0;
+    TablebaseProbePieceCount = 0;
+}
+
+Tablebase* FindTablebase(const TablebaseMaterial& material)
+{
+    const auto entry = TablebaseEntries.find(material.getMaterialHash());
+
+    return entry != TablebaseEntries.end() ? entry->second.tablebase : nullptr;
+}
+
+std::uint32_t GetTablebasePieceCount()
+{
+    return TablebasePieceCount;
+}
+
+std::uint32_t LoadTablebases(const std::string& directory)
+{
+    std::uint32_t result = 0;
+    std::error_code error;
+
+    //Only the names are read here, each table is mapped the first time a position needs it
+    for (const std::filesystem::directory_entry& file : std::filesystem::directory_iterator(directory, error)) {
+        TablebaseMaterial material;
+
+        if (file.path().extension() != TablebaseExtension) {
+            continue;
+        }
+
+        if (!ParseTablebaseMaterial(file.path().stem().string(), material)) {
+            std::cout << "Unknown tablebase " << file.path().string() << std::endl;
+            continue;
+        }
+
+        AddTablebase(std::make_unique<Tablebase>(material, file.path().string()));
+        result++;
+    }
+
+    return result;
+}
+
+void SetTablebaseProbePieceLimit(std::uint32_t pieceCount)
+{
+    TablebaseProbePieceLimit = pieceCount;
+    TablebaseProbePieceCount = std::min(TablebasePieceCount, TablebaseProbePieceLimit);
+}
+
+void SetTablebaseProbeDepth(Depth depth)
+{
+    TablebaseProbeDepth = depth;
+}
+
+static bool GetTablebaseIndex(const ChessBoard& board, const Tablebase*& tablebase, std::uint64_t& index)
+{
+    //1) The tables know nothing about castling or en passant
+    if (board.castleRights != CastleRights::CASTLE_NONE
+        || board.enPassant != Square::NO_SQUARE
+        || static_cast<std::uint32_t>(board.getPieceCount()) > TablebasePieceCount) {
+        return false;
+    }
+
+    const auto entry = TablebaseEntries.find(board.materialHashValue);
+
+    if (entry == TablebaseEntries.end()) {
+        return false;
+    }
+
+    //2) Find the position's index, swapping the colors if the weaker side is white
+    Color sideToMove;
+    TablebaseSquares squares;
+
+    if (!entry->second.tablebase->isAvailable()) {
+        return false;
+    }
+
+    tablebase = entry->second.tablebase;
+
+    if (!tablebase->getMaterial().getSquaresFromBoard(board, entry->second.flipped, sideToMove, squares)) {
+        return false;
+    }
+
+    index = tablebase->getMaterial().getIndex(sideToMove, squares);
+
+    return true;
+}
+
+bool ProbeTablebaseWdl(const ChessBoard& board, TablebaseWdl& wdl)
+{
+    if (board.getPieceCount() == 2) {
+        wdl = TABLEBASE_DRAW;
+        return true;
+    }
+
+    const Tablebase* tablebase;
+    std::uint64_t index;
+
+    if (!GetTablebaseIndex(board, tablebase, index)) {
+        return false;
+    }
+
+    wdl = tablebase->getWdl(index);
+
+    return wdl != TABLEBASE_BROKEN;
+}
+
+bool ProbeTablebaseDtz(const ChessBoard& board, TablebaseWdl& wdl, std::uint32_t& dtz)
+{
+    if (board.getPieceCount() == 2) {
+        wdl = TABLEBASE_DRAW;
+        dtz = 0;
+
+        return true;
+    }
+
+    const Tablebase* tablebase;
+    std::uint64_t index;
+
+    if (!GetTablebaseIndex(board, tablebase, index)) {
+        return false;
+    }
+
+    wdl = tablebase->getWdl(index);
+    dtz = tablebase->getDtz(index);
+
+    return wdl != TABLEBASE_BROKEN;
+}
+
+bool FilterTablebaseRootMoves(const ChessBoard& board, ChessMoveList& moveList)
+{
+    const ChessBoardMover boardMover;
+
+    if (moveList.empty()) {
+        return false;
+    }
+
+    //1) Score every move by the result it leads to, then by how quickly it makes progress
+    std::vector<std::int32_t> moveScores;
+    moveScores.reserve(moveList.size());
+
+    for (ChessMove& move : moveList) {
+        ChessBoard nextBoard = board;
+
+        const bool isZeroingMove = board.pieceAt(move.src) == PieceType::PAWN || board.pieceAt(move.dst) != PieceType::NO_PIECE;
+
+        boardMover.dispatchDoMove(nextBoard, move);
+
+        TablebaseWdl wdl;
+        std::uint32_t dtz;
+
+        if (!ProbeTablebaseDtz(nextBoard, wdl, dtz)) {
+            return false;
+        }
+
+        const std::uint32_t distance = isZeroingMove ? 1 : dtz + 1;
+
+        switch (wdl) {
+        case TABLEBASE_LOSS:
+            moveScores.push_back(2 * TablebaseMaxDtz + 2 - distance);
+            break;
+        case TABLEBASE_DRAW:
+            moveScores.push_back(0);
+            break;
+        default:
+            moveScores.push_back(-2 * std::int32_t(TablebaseMaxDtz) - 2 + std::int32_t(distance));
+            break;
+        }
+    }
+
+    //2) Keep only the moves that are as good as the best one
+    const std::int32_t bestScore = *std::max_element(moveScores.begin(), moveScores.end());
+
+    std::size_t keptMoves = 0;
+
+    for (std::size_t i = 0; i < moveList.size(); i++) {
+        if (moveScores[i] == bestScore) {
+            moveList[keptMoves++] = moveList[i];
+        }
+    }
+
+    moveList.resize(keptMoves);
+
+    return true;
+}
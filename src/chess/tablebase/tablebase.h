@@ -0,0 +1,146 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+#include "tbindex.h"
+
+#include "../../game/io/mappedfile.h"
+
+#include "../../game/types/depth.h"
+#include "../../game/types/score.h"
+
+#include "../board/board.h"
+
+#include "../types/move.h"
+
+//Two bits per position in the file, from the side to move's point of view
+enum TablebaseWdl : std::uint8_t {
+    TABLEBASE_LOSS = 0, TABLEBASE_DRAW = 1, TABLEBASE_WIN = 2, TABLEBASE_BROKEN = 3
+};
+
+const std::string DefaultTablebaseDirectory = "data/tablebases";
+
+//Plies to the next capture or pawn move on the way to the result, saturated at this value
+constexpr std::uint32_t TablebaseMaxDtz = 255;
+
+class Tablebase
+{
+protected:
+    enum TablebaseState : std::uint8_t {
+        TABLEBASE_UNLOADED, TABLEBASE_LOADED, TABLEBASE_FAILED
+    };
+
+    TablebaseMaterial material;
+    std::string fileName;
+
+    //Generated tables live in memory, while tables from files are mapped the first time they're probed
+    std::vector<std::uint8_t> generatedData;
+    MappedFile mappedFile;
+
+    const std::uint8_t* wdlData = nullptr;
+    const std::uint8_t* dtzData = nullptr;
+
+    std::atomic<TablebaseState> state = TABLEBASE_UNLOADED;
+    std::mutex loadMutex;
+
+    bool load();
+public:
+    explicit Tablebase(const TablebaseMaterial& material);
+    Tablebase(const TablebaseMaterial& material, const std::string& fileName);
+
+    const TablebaseMaterial& getMaterial() const
+    {
+        return this->material;
+    }
+
+    //Only the first probe of a table touches the file system
+    bool isAvailable()
+    {
+        const TablebaseState currentState = this->state.load(std::memory_order_acquire);
+
+        return currentState == TABLEBASE_LOADED
+            || (currentState == TABLEBASE_UNLOADED && this->load());
+    }
+
+    TablebaseWdl getWdl(std::uint64_t index) const
+    {
+        return TablebaseWdl((this->wdlData[index / 4] >> (2 * (index % 4))) & 3);
+    }
+
+    std::uint32_t getDtz(std::uint64_t index) const
+    {
+        return this->dtzData[index];
+    }
+
+    void setWdl(std::uint64_t index, TablebaseWdl wdl)
+    {
+        std::uint8_t& wdlByte = this->generatedData[index / 4];
+        wdlByte = std::uint8_t((wdlByte & ~(3 << (2 * (index % 4)))) | (wdl << (2 * (index % 4))));
+    }
+
+    void setDtz(std::uint64_t index, std::uint32_t dtz)
+    {
+        this->generatedData[(this->material.positionCount + 3) / 4 + index] = std::uint8_t(std::min(dtz, TablebaseMaxDtz));
+    }
+
+    bool save(const std::string& fileName) const;
+};
+
+std::string GetTablebaseFileName(const std::string& directory, const TablebaseMaterial& material);
+
+void AddTablebase(std::unique_ptr<Tablebase> tablebase);
+void ClearTablebases();
+
+Tablebase* FindTablebase(const TablebaseMaterial& material);
+std::uint32_t GetTablebasePieceCount();
+
+std::uint32_t LoadTablebases(const std::string& directory);
+
+extern std::uint32_t TablebaseProbePieceCount;
+extern Depth TablebaseProbeDepth;
+
+void SetTablebaseProbePieceLimit(std::uint32_t pieceCount);
+void SetTablebaseProbeDepth(Depth depth);
+
+//Search and evaluation only probe positions with few enough pieces, at nodes with enough depth left
+inline bool ShouldProbeTablebase(const ChessBoard& board, Depth depthLeft)
+{
+    return static_cast<std::uint32_t>(board.getPieceCount()) <= TablebaseProbePieceCount
+        && depthLeft >= TablebaseProbeDepth;
+}
+
+constexpr Score GetTablebaseScore(TablebaseWdl wdl, Depth currentDepth)
+{
+    return wdl == TABLEBASE_WIN ? TABLEBASE_SCORE - currentDepth
+        : (wdl == TABLEBASE_LOSS ? -TABLEBASE_SCORE + currentDepth : DRAW_SCORE);
+}
+
+bool ProbeTablebaseWdl(const ChessBoard& board, TablebaseWdl& wdl);
+bool ProbeTablebaseDtz(const ChessBoard& board, TablebaseWdl& wdl, std::uint32_t& dtz);
+
+bool FilterTablebaseRootMoves(const ChessBoard& board, ChessMoveList& moveList);
@@ -0,0 +1,456 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <map>
+
+#include "tbindex.h"
+
+#include "../../game/math/bitreset.h"
+#include "../../game/math/bitscan.h"
+#include "../../game/math/popcount.h"
+
+#include "../hash/hash.h"
+
+#include "../types/castlerights.h"
+
+static const std::string TablebasePieceLetters = " PNBRQK";
+
+//Without pawns, the white king is kept in the a1-d1-d4 triangle
+static constexpr std::uint32_t KingTriangleCount = 10;
+
+static constexpr std::uint32_t KingPawnFileCount = 32;
+
+static constexpr std::array<std::int8_t, Square::SQUARE_COUNT> KingTriangleIndex = []() constexpr {
+    std::array<std::int8_t, Square::SQUARE_COUNT> result = {};
+    std::int8_t index = 0;
+
+    for (std::int32_t src = 0; src < Square::SQUARE_COUNT; src++) {
+        const std::int32_t file = src % 8;
+        const std::int32_t row = 7 - src / 8;
+
+        result[src] = (file <= 3 && row <= file) ? index++ : -1;
+    }
+
+    return result;
+}();
+
+static constexpr std::array<Square, KingTriangleCount> KingTriangleSquares = []() constexpr {
+    std::array<Square, KingTriangleCount> result = {};
+
+    for (std::int32_t src = 0; src < Square::SQUARE_COUNT; src++) {
+        if (KingTriangleIndex[src] >= 0) {
+            result[KingTriangleIndex[src]] = Square(src);
+        }
+    }
+
+    return result;
+}();
+
+static constexpr Square TransposeSquare(Square src)
+{
+    return Square((7 - GetFile(src)) * 8 + (7 - GetRank(src)));
+}
+
+static constexpr bool IsOnKingDiagonal(Square src)
+{
+    return std::int32_t(GetFile(src)) + GetRank(src) == 7;
+}
+
+template <typename Function>
+static constexpr void TransformSquares(std::uint32_t pieceCount, TablebaseSquares& squares, Function function)
+{
+    for (std::uint32_t i = 0; i < pieceCount; i++) {
+        squares[i] = function(squares[i]);
+    }
+}
+
+static constexpr std::uint64_t PieceRadix(PieceType pieceType)
+{
+    return pieceType == PieceType::PAWN ? 48 : Square::SQUARE_COUNT;
+}
+
+static std::uint64_t ComposeIndex(const TablebaseMaterial& material, Color sideToMove, TablebaseSquares squares)
+{
+    //1) Identical pieces can be swapped, so they are always encoded in ascending square order
+    for (std::uint32_t i = 3; i < material.pieceCount; i++) {
+        for (std::uint32_t j = i; j > 2
+            && material.pieces[j] == material.pieces[j - 1]
+            && material.colors[j] == material.colors[j - 1]
+            && squares[j] < squares[j - 1]; j--) {
+            std::swap(squares[j], squares[j - 1]);
+        }
+    }
+
+    //2) Then the side to move, the white king and everything else
+    const std::uint64_t kingIndex = material.pawnCount > 0
+        ? std::uint64_t(GetRank(squares[0])) * 4 + GetFile(squares[0])
+        : std::uint64_t(KingTriangleIndex[squares[0]]);
+
+    std::uint64_t result = std::uint64_t(sideToMove) * (material.pawnCount > 0 ? KingPawnFileCount : KingTriangleCount) + kingIndex;
+
+    for (std::uint32_t i = 1; i < material.pieceCount; i++) {
+        const std::uint64_t squareIndex = material.pieces[i] == PieceType::PAWN ? squares[i] - Square::A7 : squares[i];
+
+        result = result * PieceRadix(material.pieces[i]) + squareIndex;
+    }
+
+    return result;
+}
+
+TablebasePieceCounts TablebaseMaterial::getPieceCounts() const
+{
+    TablebasePieceCounts result = {};
+
+    for (std::uint32_t i = 0; i < this->pieceCount; i++) {
+        result[this->colors[i]][this->pieces[i]]++;
+    }
+
+    return result;
+}
+
+Hash TablebaseMaterial::getMaterialHash(bool flipped) const
+{
+    const TablebasePieceCounts pieceCounts = this->getPieceCounts();
+
+    Hash result = EmptyHash;
+
+    for (Color color = Color::WHITE; color < Color::COLOR_COUNT; color++) {
+        const Color boardColor = flipped ? ~color : color;
+
+        for (PieceType pieceType = PieceType::PAWN; pieceType <= PieceType::KING; pieceType++) {
+            result ^= PieceHash(boardColor, pieceType, static_cast<Square>(pieceCounts[color][pieceType]));
+        }
+    }
+
+    return result;
+}
+
+std::string TablebaseMaterial::getName() const
+{
+    std::array<std::string, Color::COLOR_COUNT> sides;
+
+    for (std::uint32_t i = 0; i < this->pieceCount; i++) {
+        sides[this->colors[i]] += TablebasePieceLetters[this->pieces[i]];
+    }
+
+    return sides[Color::WHITE] + "v" + sides[Color::BLACK];
+}
+
+std::uint64_t TablebaseMaterial::getIndex(Color sideToMove, TablebaseSquares squares) const
+{
+    //1) Keep the white king on the a-d files
+    if (GetFile(squares[0]) > File::_D) {
+        TransformSquares(this->pieceCount, squares, FlipSquareOnVerticalLine);
+    }
+
+    if (this->pawnCount > 0) {
+        return ComposeIndex(*this, sideToMove, squares);
+    }
+
+    //2) Without pawns, ranks 1-4 and then the a1-d1-d4 triangle
+    if (GetRank(squares[0]) > Rank::_4) {
+        TransformSquares(this->pieceCount, squares, FlipSquareOnHorizontalLine);
+    }
+
+    if (std::int32_t(GetFile(squares[0])) + GetRank(squares[0]) < 7) {
+        TransformSquares(this->pieceCount, squares, TransposeSquare);
+    }
+
+    const std::uint64_t result = ComposeIndex(*this, sideToMove, squares);
+
+    //3) A king on the diagonal leaves two ways to write the position, so take the smaller one
+    if (IsOnKingDiagonal(squares[0])) {
+        TransformSquares(this->pieceCount, squares, TransposeSquare);
+
+        return std::min(result, ComposeIndex(*this, sideToMove, squares));
+    }
+
+    return result;
+}
+
+void TablebaseMaterial::getPosition(std::uint64_t index, Color& sideToMove, TablebaseSquares& squares) const
+{
+    for (std::uint32_t i = this->pieceCount - 1; i > 0; i--) {
+        const std::uint64_t radix = PieceRadix(this->pieces[i]);
+        const std::uint64_t squareIndex = index % radix;
+
+        squares[i] = Square(this->pieces[i] == PieceType::PAWN ? squareIndex + Square::A7 : squareIndex);
+        index /= radix;
+    }
+
+    if (this->pawnCount > 0) {
+        squares[0] = File(index % 4) * Rank(index % KingPawnFileCount / 4);
+        sideToMove = Color(index / KingPawnFileCount);
+    }
+    else {
+        squares[0] = KingTriangleSquares[index % KingTriangleCount];
+        sideToMove = Color(index / KingTriangleCount);
+    }
+}
+
+bool TablebaseMaterial::getSquaresFromBoard(const ChessBoard& board, bool flipped, Color& sideToMove, TablebaseSquares& squares) const
+{
+    Bitboard remaining = EmptyBitboard;
+
+    for (std::uint32_t i = 0; i < this->pieceCount; i++) {
+        //1) Start on a new bitboard whenever the piece differs from the last one
+        if (i == 0
+            || this->pieces[i] != this->pieces[i - 1]
+            || this->colors[i] != this->colors[i - 1]) {
+            const Color boardColor = flipped ? ~this->colors[i] : this->colors[i];
+            remaining = boardColor == Color::WHITE ? board.whitePieces[this->pieces[i]] : board.blackPieces[this->pieces[i]];
+        }
+
+        if (remaining == EmptyBitboard) {
+            return false;
+        }
+
+        const Square src = BitScanForward<Square>(remaining);
+        remaining = ResetLowestSetBit(remaining);
+
+        squares[i] = flipped ? FlipSquareOnHorizontalLine(src) : src;
+    }
+
+    sideToMove = flipped ? ~board.sideToMove : board.sideToMove;
+
+    return true;
+}
+
+void TablebaseMaterial::setupBoard(ChessBoard& board, Color sideToMove, const TablebaseSquares& squares) const
+{
+    board.clearEverything();
+
+    for (std::uint32_t i = 0; i < this->pieceCount; i++) {
+        Bitboard* pieces = this->colors[i] == Color::WHITE ? board.whitePieces : board.blackPieces;
+
+        board.pieces[squares[i]] = this->pieces[i];
+
+        pieces[this->pieces[i]] |= squares[i];
+        pieces[PieceType::ALL] |= squares[i];
+    }
+
+    board.allPieces = board.whitePieces[PieceType::ALL] | board.blackPieces[PieceType::ALL];
+
+    board.sideToMove = sideToMove;
+    board.castleRights = CastleRights::CASTLE_NONE;
+    board.nullMove = false;
+
+    board.materialHashValue = board.calculateMaterialHash();
+}
+
+TablebasePieceCounts GetTablebasePieceCounts(const ChessBoard& board)
+{
+    TablebasePieceCounts result = {};
+
+    for (PieceType pieceType = PieceType::PAWN; pieceType <= PieceType::KING; pieceType++) {
+        result[Color::WHITE][pieceType] = PopCount(board.whitePieces[pieceType]);
+        result[Color::BLACK][pieceType] = PopCount(board.blackPieces[pieceType]);
+    }
+
+    return result;
+}
+
+TablebaseMaterial MakeTablebaseMaterial(const TablebasePieceCounts& pieceCounts)
+{
+    TablebaseMaterial result;
+
+    //1) The side with more of the most valuable piece is white
+    Color strongSide = Color::WHITE;
+
+    for (PieceType pieceType = PieceType::QUEEN; pieceType >= PieceType::PAWN; pieceType = PieceType(pieceType - 1)) {
+        if (pieceCounts[Color::WHITE][pieceType] != pieceCounts[Color::BLACK][pieceType]) {
+            strongSide = pieceCounts[Color::WHITE][pieceType] > pieceCounts[Color::BLACK][pieceType] ? Color::WHITE : Color::BLACK;
+            break;
+        }
+    }
+
+    //2) Kings first, then each side from the queens down
+    result.pieces[0] = result.pieces[1] = PieceType::KING;
+    result.colors[0] = Color::WHITE;
+    result.colors[1] = Color::BLACK;
+    result.pieceCount = 2;
+
+    for (Color color = Color::WHITE; color < Color::COLOR_COUNT; color++) {
+        const Color boardColor = strongSide == Color::WHITE ? color : ~color;
+
+        for (PieceType pieceType = PieceType::QUEEN; pieceType >= PieceType::PAWN; pieceType = PieceType(pieceType - 1)) {
+            for (std::uint32_t i = 0; i < pieceCounts[boardColor][pieceType] && result.pieceCount < TablebaseMaxPieces; i++) {
+                result.pieces[result.pieceCount] = pieceType;
+                result.colors[result.pieceCount] = color;
+                result.pieceCount++;
+
+                if (pieceType == PieceType::PAWN) {
+                    result.pawnCount++;
+                }
+            }
+        }
+    }
+
+    //3) Both sides to move times the white king squares times every other piece's squares
+    result.positionCount = Color::COLOR_COUNT * (result.pawnCount > 0 ? KingPawnFileCount : KingTriangleCount);
+
+    for (std::uint32_t i = 1; i < result.pieceCount; i++) {
+        result.positionCount *= PieceRadix(result.pieces[i]);
+    }
+
+    return result;
+}
+
+bool ParseTablebaseMaterial(const std::string& name, TablebaseMaterial& material)
+{
+    TablebasePieceCounts pieceCounts = {};
+
+    const std::size_t separator = name.find('v');
+
+    if (separator == std::string::npos) {
+        return false;
+    }
+
+    const std::array<std::string, Color::COLOR_COUNT> sides = { name.substr(0, separator), name.substr(separator + 1) };
+
+    std::uint32_t pieceCount = 0;
+
+    for (Color color = Color::WHITE; color < Color::COLOR_COUNT; color++) {
+        if (sides[color].empty() || sides[color][0] != 'K') {
+            return false;
+        }
+
+        for (const char letter : sides[color]) {
+            const std::size_t pieceType = TablebasePieceLetters.find(letter);
+
+            if (pieceType == std::string::npos || pieceType == 0) {
+                return false;
+            }
+
+            pieceCounts[color][pieceType]++;
+            pieceCount++;
+        }
+    }
+
+    if (pieceCounts[Color::WHITE][PieceType::KING] != 1
+        || pieceCounts[Color::BLACK][PieceType::KING] != 1
+        || pieceCount <= 2
+        || pieceCount > TablebaseMaxPieces) {
+        return false;
+    }
+
+    material = MakeTablebaseMaterial(pieceCounts);
+
+    return true;
+}
+
+static void AddTablebaseMaterial(std::map<std::string, TablebaseMaterial>& materials, const TablebasePieceCounts& pieceCounts)
+{
+    const TablebaseMaterial material = MakeTablebaseMaterial(pieceCounts);
+    materials.emplace(material.getName(), material);
+}
+
+static std::vector<TablebaseMaterial> SortTablebaseMaterials(const std::map<std::string, TablebaseMaterial>& materials)
+{
+    std::vector<TablebaseMaterial> result;
+
+    for (const auto& [name, material] : materials) {
+        result.push_back(material);
+    }
+
+    //Captures lose a piece and promotions lose a pawn, so this puts every table after the ones it converts into
+    std::stable_sort(result.begin(), result.end(), [](const TablebaseMaterial& m1, const TablebaseMaterial& m2) {
+        return m1.pieceCount != m2.pieceCount ? m1.pieceCount < m2.pieceCount : m1.pawnCount < m2.pawnCount;
+    });
+
+    return result;
+}
+
+static void EnumerateTablebaseMaterials(std::map<std::string, TablebaseMaterial>& materials, TablebasePieceCounts& pieceCounts, std::uint32_t slot, std::uint32_t piecesLeft)
+{
+    //Each slot is one color and piece type from pawns to queens
+    if (slot == Color::COLOR_COUNT * (PieceType::KING - PieceType::PAWN)) {
+        if (pieceCounts != TablebasePieceCounts{}) {
+            AddTablebaseMaterial(materials, pieceCounts);
+        }
+
+        return;
+    }
+
+    const Color color = Color(slot / (PieceType::KING - PieceType::PAWN));
+    const PieceType pieceType = PieceType(PieceType::PAWN + slot % (PieceType::KING - PieceType::PAWN));
+
+    for (std::uint32_t count = 0; count <= piecesLeft; count++) {
+        pieceCounts[color][pieceType] = count;
+        EnumerateTablebaseMaterials(materials, pieceCounts, slot + 1, piecesLeft - count);
+    }
+
+    pieceCounts[color][pieceType] = 0;
+}
+
+std::vector<TablebaseMaterial> GetTablebaseMaterials(std::uint32_t maxPieceCount)
+{
+    std::map<std::string, TablebaseMaterial> materials;
+    TablebasePieceCounts pieceCounts = {};
+
+    maxPieceCount = std::min(maxPieceCount, TablebaseMaxPieces);
+
+    if (maxPieceCount > 2) {
+        EnumerateTablebaseMaterials(materials, pieceCounts, 0, maxPieceCount - 2);
+    }
+
+    return SortTablebaseMaterials(materials);
+}
+
+static void AddTablebaseMaterialDependencies(std::map<std::string, TablebaseMaterial>& materials, const TablebasePieceCounts& pieceCounts)
+{
+    const TablebaseMaterial material = MakeTablebaseMaterial(pieceCounts);
+
+    if (material.pieceCount <= 2 || !materials.emplace(material.getName(), material).second) {
+        return;
+    }
+
+    for (Color color = Color::WHITE; color < Color::COLOR_COUNT; color++) {
+        for (PieceType pieceType = PieceType::PAWN; pieceType < PieceType::KING; pieceType++) {
+            if (pieceCounts[color][pieceType] == 0) {
+                continue;
+            }
+
+            //1) Any piece can be captured
+            TablebasePieceCounts captured = pieceCounts;
+            captured[color][pieceType]--;
+
+            AddTablebaseMaterialDependencies(materials, captured);
+
+            //2) And pawns can promote
+            if (pieceType == PieceType::PAWN) {
+                for (PieceType promotionPiece = PieceType::KNIGHT; promotionPiece <= PieceType::QUEEN; promotionPiece++) {
+                    TablebasePieceCounts promoted = pieceCounts;
+                    promoted[color][PieceType::PAWN]--;
+                    promoted[color][promotionPiece]++;
+
+                    AddTablebaseMaterialDependencies(materials, promoted);
+                }
+            }
+        }
+    }
+}
+
+std::vector<TablebaseMaterial> GetTablebaseMaterialDependencies(const TablebaseMaterial& material)
+{
+    std::map<std::string, TablebaseMaterial> materials;
+    AddTablebaseMaterialDependencies(materials, material.getPieceCounts());
+
+    return SortTablebaseMaterials(materials);
+}
@@ -0,0 +1,68 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+#include "../../game/types/color.h"
+#include "../../game/types/hash.h"
+
+#include "../board/board.h"
+
+#include "../types/piecetype.h"
+#include "../types/square.h"
+
+constexpr std::uint32_t TablebaseMaxPieces = 5;
+
+using TablebasePieceCounts = std::array<std::array<std::uint32_t, PieceType::PIECETYPE_COUNT>, Color::COLOR_COUNT>;
+using TablebaseSquares = std::array<Square, TablebaseMaxPieces>;
+
+//The pieces of a table in index order: the white king, the black king, then the white and black pieces from queens
+//down to pawns.  The stronger side is always white, so the colors are swapped when probing the mirrored material.
+struct TablebaseMaterial {
+    std::array<PieceType, TablebaseMaxPieces> pieces;
+    std::array<Color, TablebaseMaxPieces> colors;
+
+    std::uint32_t pieceCount = 0;
+    std::uint32_t pawnCount = 0;
+
+    std::uint64_t positionCount = 0;
+
+    TablebasePieceCounts getPieceCounts() const;
+    Hash getMaterialHash(bool flipped = false) const;
+    std::string getName() const;
+
+    std::uint64_t getIndex(Color sideToMove, TablebaseSquares squares) const;
+    void getPosition(std::uint64_t index, Color& sideToMove, TablebaseSquares& squares) const;
+
+    bool getSquaresFromBoard(const ChessBoard& board, bool flipped, Color& sideToMove, TablebaseSquares& squares) const;
+    void setupBoard(ChessBoard& board, Color sideToMove, const TablebaseSquares& squares) const;
+};
+
+TablebasePieceCounts GetTablebasePieceCounts(const ChessBoard& board);
+
+TablebaseMaterial MakeTablebaseMaterial(const TablebasePieceCounts& pieceCounts);
+bool ParseTablebaseMaterial(const std::string& name, TablebaseMaterial& material);
+
+std::vector<TablebaseMaterial> GetTablebaseMaterials(std::uint32_t maxPieceCount);
+std::vector<TablebaseMaterial> GetTablebaseMaterialDependencies(const TablebaseMaterial& material);
@@ -0,0 +1,377 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+
+#include <cmath>
+#include <cstdio>
+
+#include "tuner.h"
+
+#include "../board/attackgenerator.h"
+
+#include "../eval/evaluator.h"
+#include "../eval/parameters.h"
+
+#include "../selfplay/packedposition.h"
+
+//Parameters reach the evaluation terms through constructors that divide, so they're measured over a wide step
+constexpr Score DerivativeStep = 256;
+
+ChessTuner::ChessTuner(const TunerSettings& settings, std::uint32_t threadCount)
+    : settings(settings), threadPool(threadCount), evalParameters(std::make_unique<EvalParameters>(DefaultEvalParameters))
+{
+    for (const auto& [name, parameter] : this->evalParameters->getParameterMap()) {
+        this->parameterNames.push_back(name);
+        this->parameters.push_back(parameter);
+        this->initialValues.push_back(*parameter);
+        this->values.push_back(double(*parameter));
+    }
+
+    this->calculateDerivatives();
+}
+
+void ChessTuner::calculateDerivatives()
+{
+    const EvaluationTermIndex termCount = GetEvaluationTermCount();
+
+    this->initialTermsMg.resize(termCount);
+    this->initialTermsEg.resize(termCount);
+
+    for (EvaluationTermIndex term = 0; term < termCount; term++) {
+        this->initialTermsMg[term] = GetEvaluationTerm(*this->evalParameters, term).mg;
+        this->initialTermsEg[term] = GetEvaluationTerm(*this->evalParameters, term).eg;
+    }
+
+    //1) Push each parameter both ways and see which terms follow
+    std::vector<ChessEvaluation> plusTerms(termCount);
+
+    this->parameterDerivatives.resize(this->parameters.size());
+
+    for (std::size_t i = 0; i < this->parameters.size(); i++) {
+        *this->parameters[i] = this->initialValues[i] + DerivativeStep;
+        this->evalParameters->build();
+
+        for (EvaluationTermIndex term = 0; term < termCount; term++) {
+            plusTerms[term] = GetEvaluationTerm(*this->evalParameters, term);
+        }
+
+        *this->parameters[i] = this->initialValues[i] - DerivativeStep;
+        this->evalParameters->build();
+
+        for (EvaluationTermIndex term = 0; term < termCount; term++) {
+            const ChessEvaluation& minusTerm = GetEvaluationTerm(*this->evalParameters, term);
+
+            const double mg = double(plusTerms[term].mg - minusTerm.mg) / (2 * DerivativeStep);
+            const double eg = double(plusTerms[term].eg - minusTerm.eg) / (2 * DerivativeStep);
+
+            if (mg != 0.0 || eg != 0.0) {
+                this->parameterDerivatives[i].push_back({ term, mg, eg });
+            }
+        }
+
+        *this->parameters[i] = this->initialValues[i];
+    }
+
+    //2) Leave the parameters as they were
+    this->evalParameters->build();
+
+    this->termsMg = this->initialTermsMg;
+    this->termsEg = this->initialTermsEg;
+}
+
+void ChessTuner::calculateTerms()
+{
+    this->termsMg = this->initialTermsMg;
+    this->termsEg = this->initialTermsEg;
+
+    for (std::size_t i = 0; i < this->parameters.size(); i++) {
+        const double change = this->values[i] - this->initialValues[i];
+
+        for (const ParameterDerivative& derivative : this->parameterDerivatives[i]) {
+            this->termsMg[derivative.term] += derivative.mg * change;
+            this->termsEg[derivative.term] += derivative.eg * change;
+        }
+    }
+}
+
+double ChessTuner::calculateLoss(double scalingConstant, std::vector<double>* gradientMg, std::vector<double>* gradientEg)
+{
+    const std::uint64_t positionCount = this->positions.size();
+    const std::uint32_t threadCount = this->threadPool.size();
+    const std::size_t termCount = this->termsMg.size();
+
+    const bool calculateGradient = gradientMg != nullptr;
+
+    //One chunk per thread, each with its own gradient to add up afterwards
+    const std::uint64_t chunkSize = (positionCount + threadCount - 1) / threadCount;
+
+    std::vector<double> errors(threadCount, 0.0);
+    std::vector<std::vector<double>> chunkGradientsMg(threadCount), chunkGradientsEg(threadCount);
+
+    this->threadPool.parallelFor(positionCount, chunkSize, [&](std::uint64_t first, std::uint64_t last) {
+        const std::uint64_t chunk = first / chunkSize;
+
+        std::vector<double>& chunkGradientMg = chunkGradientsMg[chunk];
+        std::vector<double>& chunkGradientEg = chunkGradientsEg[chunk];
+
+        if (calculateGradient) {
+            chunkGradientMg.assign(termCount, 0.0);
+            chunkGradientEg.assign(termCount, 0.0);
+        }
+
+        const double* termsMg = this->termsMg.data();
+        const double* termsEg = this->termsEg.data();
+
+        double error = 0.0;
+
+        for (std::uint64_t i = first; i < last; i++) {
+            const TracedPosition& position = this->positions[i];
+            const EvaluationTraceEntry* entries = &this->traceEntries[position.firstEntry];
+
+            //1) The score is a dot product of the trace with the terms
+            double mg = 0.0, eg = 0.0;
+
+            for (std::uint32_t j = 0; j < position.entryCount; j++) {
+                mg += entries[j].coefficient * termsMg[entries[j].term];
+                eg += entries[j].coefficient * termsEg[entries[j].term];
+            }
+
+            const double mgWeight = position.sideToMoveMultiplier * position.phase / 32.0;
+            const double egWeight = position.sideToMoveMultiplier * (32 - position.phase) / 32.0;
+
+            const double score = mg * mgWeight + eg * egWeight;
+            const double expected = 1.0 / (1.0 + std::exp(-scalingConstant * score));
+
+            error += (position.result - expected) * (position.result - expected);
+
+            //2) And so is the gradient, spread back over the same terms
+            if (calculateGradient) {
+                const double scoreGradient = 2.0 * (expected - position.result) * expected * (1.0 - expected) * scalingConstant;
+
+                for (std::uint32_t j = 0; j < position.entryCount; j++) {
+                    chunkGradientMg[entries[j].term] += scoreGradient * entries[j].coefficient * mgWeight;
+                    chunkGradientEg[entries[j].term] += scoreGradient * entries[j].coefficient * egWeight;
+                }
+            }
+        }
+
+        errors[chunk] = error;
+    });
+
+    double error = 0.0;
+
+    for (std::uint32_t chunk = 0; chunk < threadCount; chunk++) {
+        error += errors[chunk];
+    }
+
+    if (calculateGradient) {
+        gradientMg->assign(termCount, 0.0);
+        gradientEg->assign(termCount, 0.0);
+
+        for (std::uint32_t chunk = 0; chunk < threadCount; chunk++) {
+            for (std::size_t term = 0; term < chunkGradientsMg[chunk].size(); term++) {
+                (*gradientMg)[term] += chunkGradientsMg[chunk][term] / positionCount;
+                (*gradientEg)[term] += chunkGradientsEg[chunk][term] / positionCount;
+            }
+        }
+    }
+
+    return positionCount > 0 ? error / positionCount : 0.0;
+}
+
+double ChessTuner::findScalingConstant()
+{
+    //Golden section search for the constant mapping scores to expected results, which stays fixed while tuning
+    const double goldenRatio = (std::sqrt(5.0) - 1.0) / 2.0;
+
+    double low = 0.0, high = 0.02;
+    double lowGuess = high - goldenRatio * (high - low);
+    double highGuess = low + goldenRatio * (high - low);
+
+    double lowLoss = this->calculateLoss(lowGuess);
+    double highLoss = this->calculateLoss(highGuess);
+
+    for (std::uint32_t i = 0; i < 32; i++) {
+        if (lowLoss < highLoss) {
+            high = highGuess;
+            highGuess = lowGuess;
+            highLoss = lowLoss;
+            lowGuess = high - goldenRatio * (high - low);
+            lowLoss = this->calculateLoss(lowGuess);
+        }
+        else {
+            low = lowGuess;
+            lowGuess = highGuess;
+            lowLoss = highLoss;
+            highGuess = low + goldenRatio * (high - low);
+            highLoss = this->calculateLoss(highGuess);
+        }
+    }
+
+    return (low + high) / 2.0;
+}
+
+bool ChessTuner::loadPositions(const std::string& fileName)
+{
+    PackedPositionReader positionReader;
+
+    if (!positionReader.open(fileName)) {
+        return false;
+    }
+
+    const std::uint64_t positionCount = positionReader.size();
+    const std::uint32_t threadCount = this->threadPool.size();
+    const std::uint64_t chunkSize = std::max<std::uint64_t>((positionCount + threadCount - 1) / threadCount, 1);
+
+    //Evaluators are built here, on one thread, before the chunks share them out
+    std::vector<std::unique_ptr<ChessEvaluator>> evaluators;
+
+    for (std::uint32_t i = 0; i < threadCount; i++) {
+        evaluators.push_back(std::make_unique<ChessEvaluator>());
+        evaluators.back()->setEvalParameters(this->evalParameters.get());
+    }
+
+    std::vector<std::vector<TracedPosition>> chunkPositions(threadCount);
+    std::vector<std::vector<EvaluationTraceEntry>> chunkEntries(threadCount);
+
+    //1) Trace every position once, keeping the ones whose evaluation comes from the terms
+    this->threadPool.parallelFor(positionCount, chunkSize, [&](std::uint64_t first, std::uint64_t last) {
+        const std::uint64_t chunk = first / chunkSize;
+
+        const ChessAttackGenerator attackGenerator;
+        ChessEvaluator& evaluator = *evaluators[chunk];
+
+        EvaluationTrace trace;
+
+        for (std::uint64_t i = first; i < last; i++) {
+            const PackedPosition& packedPosition = positionReader[i];
+
+            if (packedPosition.result > TwoPlayerGameResult::WIN) {
+                continue;
+            }
+
+            ChessBoard board;
+            UnpackPosition(packedPosition, board);
+
+            if (attackGenerator.dispatchIsInCheck(board)) {
+                continue;
+            }
+
+            evaluator.traceEvaluation(board, trace);
+
+            if (!trace.isLinear) {
+                continue;
+            }
+
+            const TracedPosition position = {
+                chunkEntries[chunk].size(), static_cast<std::uint32_t>(trace.entries.size()),
+                trace.phase, trace.sideToMoveMultiplier,
+                packedPosition.result / 2.0
+            };
+
+            chunkPositions[chunk].push_back(position);
+            chunkEntries[chunk].insert(chunkEntries[chunk].end(), trace.entries.begin(), trace.entries.end());
+        }
+    });
+
+    //2) Then lay the chunks end to end
+    for (std::uint32_t chunk = 0; chunk < threadCount; chunk++) {
+        const std::uint64_t entryOffset = this->traceEntries.size();
+
+        for (TracedPosition& position : chunkPositions[chunk]) {
+            position.firstEntry += entryOffset;
+            this->positions.push_back(position);
+        }
+
+        this->traceEntries.insert(this->traceEntries.end(), chunkEntries[chunk].begin(), chunkEntries[chunk].end());
+    }
+
+    return true;
+}
+
+void ChessTuner::tune()
+{
+    const std::size_t parameterCount = this->parameters.size();
+
+    std::vector<double> firstMoment(parameterCount, 0.0), secondMoment(parameterCount, 0.0);
+    std::vector<double> gradientMg, gradientEg;
+
+    this->calculateTerms();
+    this->scalingConstant = this->findScalingConstant();
+
+    std::printf("Scaling constant %.6f, loss %.8f\n", this->scalingConstant, this->calculateLoss(this->scalingConstant));
+
+    for (std::uint32_t epoch = 1; epoch <= this->settings.epochs; epoch++) {
+        const auto startTime = std::chrono::steady_clock::now();
+
+        //1) The gradient of every term, then of every parameter through the terms built from it
+        const double loss = this->calculateLoss(this->scalingConstant, &gradientMg, &gradientEg);
+
+        const double firstCorrection = 1.0 - std::pow(this->settings.beta1, epoch);
+        const double secondCorrection = 1.0 - std::pow(this->settings.beta2, epoch);
+
+        for (std::size_t i = 0; i < parameterCount; i++) {
+            double gradient = 0.0;
+
+            for (const ParameterDerivative& derivative : this->parameterDerivatives[i]) {
+                gradient += derivative.mg * gradientMg[derivative.term] + derivative.eg * gradientEg[derivative.term];
+            }
+
+            //2) Then step with Adam
+            firstMoment[i] = this->settings.beta1 * firstMoment[i] + (1.0 - this->settings.beta1) * gradient;
+            secondMoment[i] = this->settings.beta2 * secondMoment[i] + (1.0 - this->settings.beta2) * gradient * gradient;
+
+            const double firstEstimate = firstMoment[i] / firstCorrection;
+            const double secondEstimate = secondMoment[i] / secondCorrection;
+
+            this->values[i] -= this->settings.learningRate * firstEstimate / (std::sqrt(secondEstimate) + 1e-12);
+        }
+
+        this->calculateTerms();
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+
+        std::printf("Epoch %u loss %.8f (%lld ms)\n", epoch, loss, static_cast<long long>(elapsed.count()));
+    }
+
+    std::printf("Final loss %.8f\n", this->calculateLoss(this->scalingConstant));
+}
+
+bool ChessTuner::savePersonality(const std::string& fileName) const
+{
+    std::ofstream personalityFile(fileName, std::ios::out | std::ios::trunc);
+
+    if (!personalityFile) {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < this->parameters.size(); i++) {
+        const Score change = Score(std::lround(this->values[i])) - this->initialValues[i];
+
+        if (change != 0) {
+            personalityFile << this->parameterNames[i] << ' ' << change << '\n';
+        }
+    }
+
+    personalityFile.close();
+
+    return static_cast<bool>(personalityFile);
+}
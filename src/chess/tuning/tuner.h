@@ -0,0 +1,109 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+#include "../eval/parameters.h"
+#include "../eval/trace.h"
+
+#include "../../game/personality/parametermap.h"
+#include "../../game/threads/threadpool.h"
+
+struct TunerSettings {
+    std::uint32_t epochs = 500;
+
+    //Adam's step size, in score units
+    double learningRate = 1.0;
+    double beta1 = 0.9;
+    double beta2 = 0.999;
+};
+
+//Where a position's trace lives, and what it needs to be scored
+struct TracedPosition {
+    std::uint64_t firstEntry;
+    std::uint32_t entryCount;
+
+    std::int32_t phase;
+    std::int32_t sideToMoveMultiplier;
+
+    double result;
+};
+
+//How much an evaluation term moves when a parameter it's built from does
+struct ParameterDerivative {
+    EvaluationTermIndex term;
+    double mg, eg;
+};
+
+//Fits the evaluation parameters to game results, the loss being the squared error between the result and a sigmoid of the evaluation.
+//Every position is traced once, after which scores and gradients come from the traces alone.
+class ChessTuner
+{
+protected:
+    TunerSettings settings;
+
+    ThreadPool threadPool;
+
+    std::vector<TracedPosition> positions;
+    std::vector<EvaluationTraceEntry> traceEntries;
+
+    //The tuner's own copy, so measuring the parameters doesn't disturb anyone else
+    std::unique_ptr<EvalParameters> evalParameters;
+
+    std::vector<Parameter> parameterNames;
+    std::vector<Score*> parameters;
+    std::vector<Score> initialValues;
+    std::vector<double> values;
+
+    std::vector<std::vector<ParameterDerivative>> parameterDerivatives;
+
+    std::vector<double> initialTermsMg, initialTermsEg;
+    std::vector<double> termsMg, termsEg;
+
+    double scalingConstant = 0.0;
+
+    void calculateDerivatives();
+    void calculateTerms();
+
+    double calculateLoss(double scalingConstant, std::vector<double>* gradientMg = nullptr, std::vector<double>* gradientEg = nullptr);
+    double findScalingConstant();
+public:
+    ChessTuner(const TunerSettings& settings, std::uint32_t threadCount = 0);
+
+    bool loadPositions(const std::string& fileName);
+    void tune();
+
+    //Personality files hold the change to each parameter, not its value
+    bool savePersonality(const std::string& fileName) const;
+
+    std::size_t getParameterCount() const
+    {
+        return this->parameters.size();
+    }
+
+    std::size_t getPositionCount() const
+    {
+        return this->positions.size();
+    }
+};
@@ -1,22 +1,75 @@
 #pragma once
 
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
 #include <map>
 #include <string>
 
+#include "../io/mappedfile.h"
+
 #include "../types/book.h"
 #include "../types/hash.h"
 #include "../types/movelist.h"
 #include "../types/nodecount.h"
 
-template <class Board, class BookPosition = DefaultBookPosition>
+//Book files are fixed size BookPosition records sorted by hash, so they can be mapped and searched in place
+template <class Board, class BoardMover, class BookPosition = DefaultBookPosition>
 class Book {
 private:
 	using MoveListIterator = typename std::vector<typename Board::MoveType>::iterator;
+
+	//Hashes are uniformly distributed, so interpolation gets close in a few steps before binary search finishes
+	static constexpr std::uint32_t MaxInterpolationSteps = 4;
 protected:
 	using BookPositionMap = std::map<Hash, BookPosition>;
 	using BookPositionMapIterator = typename std::map<Hash, BookPosition>::iterator;
 
+	//Positions added since the file was loaded
 	BookPositionMap positionMap;
+
+	MappedFile bookFile;
+	std::string bookFileName;
+
+	const BoardMover boardMover;
+
+	const BookPosition* bookPositions = nullptr;
+	std::size_t bookPositionCount = 0;
+
+	const BookPosition* findBookPosition(Hash hashValue) const
+	{
+		std::size_t low = 0, high = this->bookPositionCount;
+
+		//1) Guess where the hash would be if the hashes were evenly spread
+		for (std::uint32_t step = 0; step < MaxInterpolationSteps && high - low > 8; step++) {
+			const Hash lowHash = this->bookPositions[low].hashValue;
+			const Hash highHash = this->bookPositions[high - 1].hashValue;
+
+			if (hashValue < lowHash || hashValue > highHash) {
+				return nullptr;
+			}
+
+			const double fraction = double(hashValue - lowHash) / double(highHash - lowHash + 1);
+			const std::size_t guess = low + std::min(std::size_t(fraction * double(high - low)), high - low - 1);
+			const Hash guessHash = this->bookPositions[guess].hashValue;
+
+			if (guessHash == hashValue) {
+				return &this->bookPositions[guess];
+			}
+			else if (guessHash < hashValue) {
+				low = guess + 1;
+			}
+			else {
+				high = guess;
+			}
+		}
+
+		//2) Then narrow down the rest of the range
+		const BookPosition* position = std::lower_bound(this->bookPositions + low, this->bookPositions + high, hashValue,
+			[](const BookPosition& bookPosition, Hash hashValue) { return bookPosition.hashValue < hashValue; });
+
+		return position != this->bookPositions + high && position->hashValue == hashValue ? position : nullptr;
+	}
 public:
 	using BoardType = Board;
 	using MoveType = typename BoardType::MoveType;
@@ -39,14 +92,15 @@ public:
 		bookPosition.hashValue = hashValue;
 	}
 
-	NodeCount getBookMoves(BoardType& board, MoveList<MoveType>& moveList)
+	//Keeps only the moves leading to a position in the book
+	NodeCount getBookMoves(const BoardType& board, MoveList<MoveType>& moveList) const
 	{
 		MoveListIterator it = moveList.begin();
 		while (it != moveList.end()) {
 			BoardType nextBoard = board;
 			MoveType& move = *it;
 
-			nextBoard.doMove();
+			this->boardMover.dispatchDoMove(nextBoard, move);
 
 			if (!this->hasPosition(nextBoard.hashValue)) {
 				it = moveList.erase(it);
@@ -59,70 +113,146 @@ public:
 		return moveList.size();
 	}
 
-	BookPosition& getPosition(Hash hashValue)
+	//Combines what the file and the added positions know about a position
+	BookPosition getPosition(Hash hashValue) const
 	{
-		return this->positionMap.find(hashValue)->second;
+		BookPosition bookPosition = {};
+		bookPosition.hashValue = hashValue;
+
+		const BookPosition* filePosition = this->findBookPosition(hashValue);
+
+		if (filePosition != nullptr) {
+			bookPosition += *filePosition;
+		}
+
+		const auto it = this->positionMap.find(hashValue);
+
+		if (it != this->positionMap.end()) {
+			bookPosition += it->second;
+		}
+
+		return bookPosition;
 	}
 
-	bool hasPosition(Hash hashValue)
+	bool hasPosition(Hash hashValue) const
 	{
-		return this->positionMap.count(hashValue) > 0;
+		return this->findBookPosition(hashValue) != nullptr
+			|| this->positionMap.count(hashValue) > 0;
 	}
 
-	bool loadFromFile(std::string& fileName)
+	bool loadFromFile(const std::string& fileName)
 	{
-		std::fstream bookFile;
+		this->bookFileName.clear();
+		this->bookPositions = nullptr;
+		this->bookPositionCount = 0;
+
+		if (!this->bookFile.open(fileName)) {
+			//Files can't map an empty range, but an empty file is still a valid empty book
+			std::error_code error;
+			const bool isEmpty = std::filesystem::is_regular_file(fileName, error) && std::filesystem::file_size(fileName, error) == 0;
 
-		bookFile.open(fileName, std::fstream::ios_base::in | std::fstream::ios_base::binary);
+			if (error || !isEmpty) {
+				return false;
+			}
 
-		if (!bookFile.is_open()) {
+			this->bookFileName = fileName;
+			return true;
+		}
+
+		if (this->bookFile.getSize() % sizeof(BookPosition) != 0) {
+			this->bookFile.close();
 			return false;
 		}
 
-		while (!bookFile.eof()) {
-			BookPosition learningBookPosition;
+		this->bookPositions = reinterpret_cast<const BookPosition*>(this->bookFile.getData());
+		this->bookPositionCount = this->bookFile.getSize() / sizeof(BookPosition);
+		this->bookFileName = fileName;
+
+		return true;
+	}
+
+	//Merges the added positions into the loaded ones, keeping the records sorted
+	bool saveToFile(const std::string& fileName)
+	{
+		std::fstream outputFile;
 
-			bookFile.read((char*)&learningBookPosition, sizeof(learningBookPosition));
+		//The file being written may be the one that's mapped, so write beside it first
+		const std::string temporaryFileName = fileName + ".tmp";
 
-			Hash hashValue = learningBookPosition.hashValue;
-			this->addPosition(hashValue);
+		outputFile.open(temporaryFileName, std::fstream::ios_base::out | std::fstream::ios_base::binary | std::fstream::ios_base::trunc);
 
-			BookPosition& currentBookPosition = this->positionMap.find(hashValue)->second;
-			currentBookPosition += learningBookPosition;
+		if (!outputFile.is_open()) {
+			return false;
 		}
 
-		bookFile.close();
+		//1) Both the file and the map are sorted by hash
+		std::size_t filePositionIndex = 0;
+		BookPositionMapIterator it = this->positionMap.begin();
 
-		return true;
-	}
+		while (filePositionIndex < this->bookPositionCount || it != this->positionMap.end()) {
+			BookPosition bookPosition;
 
-	bool saveToFile(std::string& fileName)
-	{
-		std::fstream bookFile;
+			if (it == this->positionMap.end()
+				|| (filePositionIndex < this->bookPositionCount && this->bookPositions[filePositionIndex].hashValue < it->first)) {
+				bookPosition = this->bookPositions[filePositionIndex++];
+			}
+			else {
+				bookPosition = it->second;
+				bookPosition.hashValue = it->first;
 
-		bookFile.open(fileName, std::fstream::ios_base::out | std::fstream::ios_base::binary | std::fstream::ios_base::trunc);
+				if (filePositionIndex < this->bookPositionCount && this->bookPositions[filePositionIndex].hashValue == it->first) {
+					bookPosition += this->bookPositions[filePositionIndex++];
+				}
 
-		if (!bookFile.is_open()) {
+				++it;
+			}
+
+			if (bookPosition.hashValue != EmptyHash) {
+				outputFile.write((const char*)&(bookPosition), sizeof(BookPosition));
+			}
+		}
+
+		outputFile.close();
+
+		if (!outputFile) {
 			return false;
 		}
 
-		for (BookPositionMapIterator it = this->positionMap.begin(); it != this->positionMap.end(); ++it) {
-			Hash positionHash = it->first;
-			BookPosition& bookPosition = it->second;
+		//2) Swap the new file in and map it.  The mapping has to go first, since Windows can't replace a mapped file.
+		const std::string previousFileName = this->bookFileName;
+
+		this->bookFile.close();
+		this->bookFileName.clear();
+		this->bookPositions = nullptr;
+		this->bookPositionCount = 0;
+
+		std::error_code error;
+		std::filesystem::rename(temporaryFileName, fileName, error);
 
-			if (positionHash != EmptyHash
-				&& bookPosition.hashValue == positionHash) {
-				bookFile.write((const char*)&(bookPosition), sizeof(BookPosition));
+		if (error) {
+			//Keep the book that was loaded, along with the positions that weren't saved
+			std::filesystem::remove(temporaryFileName, error);
+
+			if (!previousFileName.empty()) {
+				this->loadFromFile(previousFileName);
 			}
+
+			return false;
 		}
 
-		bookFile.close();
+		this->positionMap.clear();
 
-		return true;
+		return this->loadFromFile(fileName);
 	}
 
-	size_type size()
+	size_type size() const
 	{
-		return this->positionMap.size();
+		size_type result = this->bookPositionCount;
+
+		for (const auto& [hashValue, bookPosition] : this->positionMap) {
+			result += this->findBookPosition(hashValue) == nullptr ? 1 : 0;
+		}
+
+		return result;
 	}
 };
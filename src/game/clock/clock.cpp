@@ -17,9 +17,60 @@
 */
 
 #include <algorithm>
+#include <iostream>
+
+#include <cstdlib>
 
 #include "clock.h"
 
+//Limits on how far best move instability and score swings can stretch or shrink the soft limit, in percent
+constexpr std::int32_t MinimumStabilityPercent = 50;
+constexpr std::int32_t MaximumStabilityPercent = 160;
+constexpr std::int32_t StabilityPercentStep = 20;
+constexpr std::int32_t MaximumScoreSwingPercent = 80;
+
+//Bounds on the effective branching factor used to predict the next iteration
+constexpr float MinimumBranchingFactor = 1.5f;
+constexpr float MaximumBranchingFactor = 6.0f;
+
+void Clock::calculateTimeLimits()
+{
+    std::time_t millisecondsPerMove;
+
+    //1) Base allocation, the same split of the remaining time we have always used
+    if (this->Level.moves == 0) {
+        millisecondsPerMove = this->engineTimeLeft / 30 + this->Level.increment;
+    }
+    else if (this->movesLeft <= 1) {
+        millisecondsPerMove = this->engineTimeLeft;
+    }
+    else {
+        millisecondsPerMove = this->engineTimeLeft / this->movesLeft + this->Level.increment;
+    }
+
+    //2) The hard limit lets an unstable search run several times longer, but never eat more than a third of what's left
+    std::time_t maximumMilliseconds = std::min(millisecondsPerMove * 4, std::max(this->engineTimeLeft / 3, millisecondsPerMove));
+    maximumMilliseconds = std::min(maximumMilliseconds, this->engineTimeLeft);
+
+    //3) Both leave room for the latency we've seen, which can never be more than we have
+    const std::time_t moveOverhead = std::min(this->getMoveOverhead(), this->engineTimeLeft / 2);
+
+    this->softTimeLimit = std::max(std::min(millisecondsPerMove, maximumMilliseconds) - moveOverhead, std::time_t(1));
+    this->hardTimeLimit = std::max(maximumMilliseconds - moveOverhead, std::time_t(1));
+}
+
+std::time_t Clock::predictNextIterationTime() const
+{
+    if (this->previousIterationTime <= 0) {
+        return static_cast<std::time_t>(this->lastIterationTime * MaximumBranchingFactor);
+    }
+
+    float branchingFactor = static_cast<float>(this->lastIterationTime) / this->previousIterationTime;
+    branchingFactor = std::clamp(branchingFactor, MinimumBranchingFactor, MaximumBranchingFactor);
+
+    return static_cast<std::time_t>(this->lastIterationTime * branchingFactor);
+}
+
 void Clock::decrementMovesLeft()
 {
     this->movesLeft--;
@@ -39,6 +90,18 @@ std::time_t Clock::getElapsedTime(NodeCount nodeCount)
     return std::time_t(elapsedTime.count());
 }
 
+std::time_t Clock::getMoveOverhead() const
+{
+    if (this->latencyStatistics.size() == 0) {
+        return this->moveOverhead;
+    }
+
+    //Reserve for a bad move, not an average one
+    const std::time_t measuredOverhead = this->latencyStatistics.average() + static_cast<std::time_t>(2.0f * this->latencyStatistics.stddev());
+
+    return std::clamp(measuredOverhead, this->moveOverhead, MaximumMoveOverhead);
+}
+
 std::time_t Clock::getTimeLeft(NodeCount nodeCount)
 {
     return this->engineTimeLeft;
@@ -46,19 +109,90 @@ std::time_t Clock::getTimeLeft(NodeCount nodeCount)
 
 bool Clock::handleSearchLevel(NodeCount nodeCount)
 {
-    std::time_t millisecondsPerMove;
+    return this->getElapsedTime(nodeCount) < this->hardTimeLimit;
+}
 
-    if (this->Level.moves == 0) {
-        millisecondsPerMove = this->engineTimeLeft / 30 + this->Level.increment;
+void Clock::onMoveRequested()
+{
+    //A move without a following time command only has our own latency to go by
+    if (this->awaitingTimeUpdate) {
+        this->latencyStatistics.push_back(std::max(this->lastResponseTime - this->lastSearchTime, std::time_t(0)));
+        this->awaitingTimeUpdate = false;
     }
-    else if (this->movesLeft == 1) {
-        millisecondsPerMove = this->engineTimeLeft;
+
+    this->moveRequestTime = SteadyClock::now();
+    this->engineTimeLeftAtMoveRequest = this->engineTimeLeft;
+    this->lastSearchTime = 0;
+}
+
+void Clock::onMoveSent()
+{
+    //Faked time says nothing about latency
+    if (this->nps != ZeroNodes) {
+        return;
+    }
+
+    const std::chrono::milliseconds responseTime = std::chrono::duration_cast<std::chrono::milliseconds>(SteadyClock::now() - this->moveRequestTime);
+
+    this->lastResponseTime = std::time_t(responseTime.count());
+    this->awaitingTimeUpdate = true;
+}
+
+void Clock::onSearchCompleted(std::time_t searchTime)
+{
+    this->lastSearchTime = searchTime;
+}
+
+void Clock::printLatencySummary() const
+{
+    if (this->latencyStatistics.size() == 0) {
+        return;
+    }
+
+    std::cout << "# Latency over " << this->latencyStatistics.size() << " moves: average " << this->latencyStatistics.average()
+        << " ms, deviation " << this->latencyStatistics.stddev()
+        << " ms, worst " << this->latencyStatistics.maximum()
+        << " ms, overhead reserved " << this->getMoveOverhead() << " ms" << std::endl;
+}
+
+void Clock::resetLatencyStatistics()
+{
+    this->latencyStatistics.clear();
+    this->awaitingTimeUpdate = false;
+}
+
+void Clock::onDepthCompleted(Depth depth, Score score, bool bestMoveChanged, NodeCount nodeCount)
+{
+    const std::time_t elapsedTime = this->getElapsedTime(nodeCount);
+
+    //1) Track how long each iteration took, for the branching factor
+    this->previousIterationTime = this->lastIterationTime;
+    this->lastIterationTime = std::max(elapsedTime - this->lastDepthCompletedTime, std::time_t(1));
+    this->lastDepthCompletedTime = elapsedTime;
+
+    //2) A best move that keeps changing buys more time, a settled one lets us move early
+    if (bestMoveChanged) {
+        this->bestMoveStability = 0;
     }
     else {
-        millisecondsPerMove = this->engineTimeLeft / this->movesLeft + this->Level.increment;
+        this->bestMoveStability++;
+    }
+
+    const std::int32_t stabilityPercent = std::max(MaximumStabilityPercent - StabilityPercentStep * static_cast<std::int32_t>(this->bestMoveStability), MinimumStabilityPercent);
+
+    //3) So does a score that swings between iterations, mate scores aside
+    std::int32_t scoreSwingPercent = 0;
+    if (this->previousScore != NO_SCORE
+        && !IsMateScore(score)
+        && !IsMateScore(this->previousScore)) {
+        const std::int32_t scoreSwing = std::abs(score - this->previousScore);
+        scoreSwingPercent = std::min(scoreSwing * 100 / (UNIT_SCORE * 2), MaximumScoreSwingPercent);
     }
 
-    return this->getElapsedTime(nodeCount) < std::max(static_cast<std::int32_t>(millisecondsPerMove) - 20, 1);
+    this->previousScore = score;
+
+    const std::time_t adjustedSoftTimeLimit = this->softTimeLimit * stabilityPercent / 100 * (100 + scoreSwingPercent) / 100;
+    this->adjustedSoftTimeLimit = std::min(adjustedSoftTimeLimit, this->hardTimeLimit);
 }
 
 void Clock::setClockDepth(Depth depth)
@@ -70,6 +204,17 @@ void Clock::setClockDepth(Depth depth)
 
 void Clock::setClockEngineTimeLeft(std::time_t engineTimeLeft)
 {
+    //1) The interface's view of our last move, less the time we searched, is the latency it charged us
+    if (this->awaitingTimeUpdate) {
+        const std::time_t chargedTime = this->engineTimeLeftAtMoveRequest + this->Level.increment - engineTimeLeft;
+
+        //2) A new time control period adds time, which hides what we were charged
+        const std::time_t latency = chargedTime >= 0 ? chargedTime - this->lastSearchTime : this->lastResponseTime - this->lastSearchTime;
+
+        this->latencyStatistics.push_back(std::max(latency, std::time_t(0)));
+        this->awaitingTimeUpdate = false;
+    }
+
     this->engineTimeLeft = engineTimeLeft;
 }
 
@@ -109,12 +254,42 @@ void Clock::setClockSearchTime(std::time_t milliseconds)
     this->maxSearchTime = milliseconds;
 }
 
+void Clock::setMoveOverhead(std::time_t milliseconds)
+{
+    this->moveOverhead = std::clamp(milliseconds, std::time_t(0), MaximumMoveOverhead);
+}
+
 void Clock::setMovesLeft(std::uint32_t movesLeft)
 {
     this->movesLeft = movesLeft;
 }
 
-bool Clock::shouldContinueSearch(Depth depth, NodeCount nodeCount)
+bool Clock::shouldStartNextDepth(Depth depth, NodeCount nodeCount)
+{
+    if (!this->shouldContinueSearch(depth, nodeCount)) {
+        return false;
+    }
+
+    const std::time_t elapsedTime = this->getElapsedTime(nodeCount);
+
+    switch (this->clockType) {
+    case ClockType::SEARCHTIME:
+        //An iteration we cannot finish is thrown away, so don't start it
+        return elapsedTime + this->predictNextIterationTime() < this->hardTimeLimit;
+    case ClockType::SEARCHLEVEL:
+        if (elapsedTime >= this->adjustedSoftTimeLimit) {
+            return false;
+        }
+
+        return elapsedTime + this->predictNextIterationTime() < this->hardTimeLimit;
+    default:
+        break;
+    }
+
+    return true;
+}
+
+bool Clock::checkSearchLimits(Depth depth, NodeCount nodeCount)
 {
     if (depth >= Depth::MAX) {
         return false;
@@ -126,6 +301,7 @@ bool Clock::shouldContinueSearch(Depth depth, NodeCount nodeCount)
             this->minimumDepthReached = true;
         }
         else {
+            this->scheduleNextCheck(nodeCount);
             return true;
         }
     }
@@ -133,42 +309,99 @@ bool Clock::shouldContinueSearch(Depth depth, NodeCount nodeCount)
     if (this->nps != ZeroNodes) {
         //If we've received an nps command, we are going by faked search time
         const NodeCount maxNodes = this->nps * this->maxSearchTime / 1000;
-        return nodeCount < maxNodes;
+
+        if (nodeCount >= maxNodes) {
+            this->nextCheckNodeCount = ZeroNodes;
+            return false;
+        }
+
+        this->scheduleNextCheck(nodeCount);
+        return true;
     }
 
+    bool result = true;
+
     switch (this->clockType) {
     case ClockType::NO_CLOCK:
         return false;
     case ClockType::SEARCHTIME:
-        if (this->getElapsedTime(nodeCount) >= this->maxSearchTime) {
-            return false;
-        }
+        result = this->getElapsedTime(nodeCount) < this->hardTimeLimit;
         break;
     case ClockType::SEARCHDEPTH:
-        if (depth >= this->maxSearchDepth) {
-            return false;
-        }
+        result = depth < this->maxSearchDepth;
         break;
     case ClockType::SEARCHNODES:
-        if (nodeCount >= this->maxSearchNodes) {
-            return false;
-        }
+        result = nodeCount < this->maxSearchNodes;
         break;
     case ClockType::SEARCHLEVEL:
-        if (nodeCount % 1024 != 0) {
-            return true;
-        }
-
-        return this->handleSearchLevel(nodeCount);
+        result = this->handleSearchLevel(nodeCount);
+        break;
     default:
         break;
     }
 
-    return true;
+    //A stop is final, so every later call checks again and fails instead of taking the fast path
+    if (result) {
+        this->scheduleNextCheck(nodeCount);
+    }
+    else {
+        this->nextCheckNodeCount = ZeroNodes;
+    }
+
+    return result;
+}
+
+void Clock::scheduleNextCheck(NodeCount nodeCount)
+{
+    //1) Aim for roughly one clock read per millisecond of search, based on the speed since the last read
+    if (this->nps == ZeroNodes
+        && (this->clockType == ClockType::SEARCHTIME || this->clockType == ClockType::SEARCHLEVEL)) {
+        const std::time_t elapsedTime = this->getElapsedTime(nodeCount);
+
+        if (elapsedTime > this->lastCheckTime
+            && nodeCount > this->lastCheckNodeCount) {
+            const NodeCount nodesPerMillisecond = (nodeCount - this->lastCheckNodeCount) / (elapsedTime - this->lastCheckTime);
+
+            this->checkInterval = std::clamp(nodesPerMillisecond, MinimumCheckInterval, MaximumCheckInterval);
+            this->lastCheckTime = elapsedTime;
+            this->lastCheckNodeCount = nodeCount;
+        }
+    }
+
+    this->nextCheckNodeCount = nodeCount + this->checkInterval;
+
+    //2) Node based limits are exact, so never step past them
+    if (this->nps != ZeroNodes) {
+        this->nextCheckNodeCount = std::min(this->nextCheckNodeCount, this->nps * this->maxSearchTime / 1000);
+    }
+    else if (this->clockType == ClockType::SEARCHNODES) {
+        this->nextCheckNodeCount = std::min(this->nextCheckNodeCount, this->maxSearchNodes);
+    }
 }
 
 void Clock::startClock()
 {
     this->minimumDepthReached = false;
+
+    this->lastDepthCompletedTime = 0;
+    this->lastIterationTime = 0;
+    this->previousIterationTime = 0;
+
+    this->bestMoveStability = 0;
+    this->previousScore = NO_SCORE;
+
+    this->checkInterval = DefaultCheckInterval;
+    this->nextCheckNodeCount = this->checkInterval;
+    this->lastCheckTime = 0;
+    this->lastCheckNodeCount = ZeroNodes;
+
+    if (this->clockType == ClockType::SEARCHLEVEL) {
+        this->calculateTimeLimits();
+        this->adjustedSoftTimeLimit = this->softTimeLimit;
+    }
+    else if (this->clockType == ClockType::SEARCHTIME) {
+        this->hardTimeLimit = std::max(this->maxSearchTime - std::min(this->getMoveOverhead(), this->maxSearchTime / 2), std::time_t(1));
+    }
+
     this->startTime = SteadyClock::now();
 }
@@ -22,14 +22,24 @@
 
 #include <ctime>
 
+#include "../math/statistics.h"
+
 #include "../types/depth.h"
 #include "../types/nodecount.h"
+#include "../types/score.h"
 
 enum ClockType {
     NO_CLOCK,
     SEARCHTIME, SEARCHDEPTH, SEARCHNODES, SEARCHLEVEL
 };
 
+constexpr std::time_t DefaultMoveOverhead = 20;
+constexpr std::time_t MaximumMoveOverhead = 5000;
+
+constexpr NodeCount DefaultCheckInterval = 1024;
+constexpr NodeCount MinimumCheckInterval = 256;
+constexpr NodeCount MaximumCheckInterval = 65536;
+
 class Clock {
 protected:
     using SteadyClock = std::chrono::steady_clock;
@@ -54,6 +64,38 @@ protected:
 
     bool minimumDepthReached;
 
+    //Time management: the soft limit is the target for a move, adjusted by how stable the search is,
+    //the hard limit is the most we will ever spend on it
+    std::time_t softTimeLimit, hardTimeLimit;
+    std::time_t adjustedSoftTimeLimit;
+
+    std::time_t lastDepthCompletedTime;
+    std::time_t lastIterationTime, previousIterationTime;
+
+    std::uint32_t bestMoveStability;
+    Score previousScore;
+
+    //Search limits are only examined every checkInterval nodes, the interval tracking the search speed
+    NodeCount checkInterval, nextCheckNodeCount;
+    std::time_t lastCheckTime;
+    NodeCount lastCheckNodeCount;
+
+    //Latency between the time our search stops and the time the interface charges us for,
+    //measured over the game and folded into the overhead we reserve
+    std::time_t moveOverhead;
+    Statistics<std::time_t> latencyStatistics;
+
+    std::chrono::time_point<SteadyClock> moveRequestTime;
+    std::time_t engineTimeLeftAtMoveRequest;
+    std::time_t lastSearchTime, lastResponseTime;
+    bool awaitingTimeUpdate;
+
+    bool checkSearchLimits(Depth depth, NodeCount nodeCount);
+    void scheduleNextCheck(NodeCount nodeCount);
+
+    void calculateTimeLimits();
+    std::time_t predictNextIterationTime() const;
+
     bool handleSearchLevel(NodeCount nodeCount);
 public:
     constexpr Clock()
@@ -68,15 +110,46 @@ public:
         this->clockType = ClockType::NO_CLOCK;
         this->minimumDepthReached = false;
         this->nps = ZeroNodes;
+
+        this->checkInterval = DefaultCheckInterval;
+        this->nextCheckNodeCount = ZeroNodes;
+
+        this->engineTimeLeft = 0;
+        this->Level.increment = 0;
+
+        this->moveOverhead = DefaultMoveOverhead;
+        this->lastSearchTime = 0;
+        this->awaitingTimeUpdate = false;
     }
 
     std::time_t getElapsedTime(NodeCount nodeCount);
     std::time_t getTimeLeft(NodeCount nodeCount = ZeroNodes);
 
-    bool shouldContinueSearch(Depth depth, NodeCount nodeCount);
+    constexpr bool shouldContinueSearch(Depth depth, NodeCount nodeCount)
+    {
+        //Called at every node, so the common case is a single compare
+        if (depth == Depth::ZERO
+            && nodeCount < this->nextCheckNodeCount) {
+            return true;
+        }
+
+        return this->checkSearchLimits(depth, nodeCount);
+    }
 
     void decrementMovesLeft();
 
+    std::time_t getMoveOverhead() const;
+
+    void onMoveRequested();
+    void onMoveSent();
+    void onSearchCompleted(std::time_t searchTime);
+
+    void printLatencySummary() const;
+    void resetLatencyStatistics();
+
+    void onDepthCompleted(Depth depth, Score score, bool bestMoveChanged, NodeCount nodeCount);
+    bool shouldStartNextDepth(Depth depth, NodeCount nodeCount);
+
     void setClockDepth(Depth depth);
     void setClockEngineTimeLeft(std::time_t engineTimeLeft);
     void setClockLevel(NodeCount moveCount, std::time_t milliseconds, std::time_t increment);
@@ -85,6 +158,7 @@ public:
     void setClockNps(NodeCount nps);
     void setClockOpponentTimeLeft(std::time_t opponentTimeLeft);
     void setClockSearchTime(std::time_t milliseconds);
+    void setMoveOverhead(std::time_t milliseconds);
 
     void startClock();
 };
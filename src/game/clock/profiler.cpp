@@ -0,0 +1,97 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+
+#include "profiler.h"
+
+static const char* ProfilePhaseNames[ProfilePhase::PROFILEPHASE_COUNT] = {
+    "search",
+    "move generation",
+    "move ordering",
+    "static exchange",
+    "evaluation",
+    "do move",
+    "hashtable probe"
+};
+
+thread_local CycleProfilerThreadState CycleProfilerState;
+
+static std::mutex CycleProfileMutex;
+static CycleProfile SharedCycleProfile;
+
+void CycleProfile::merge(const CycleProfile& cycleProfile)
+{
+    for (std::uint32_t i = 0; i < ProfilePhase::PROFILEPHASE_COUNT; i++) {
+        this->cycles[i] += cycleProfile.cycles[i];
+        this->calls[i] += cycleProfile.calls[i];
+    }
+}
+
+void CycleProfile::print() const
+{
+    std::uint64_t totalCycles = 0;
+
+    for (const std::uint64_t phaseCycles : this->cycles) {
+        totalCycles += phaseCycles;
+    }
+
+    std::cout << std::left << std::setw(18) << "phase" << std::right
+        << std::setw(14) << "calls" << std::setw(18) << "cycles" << std::setw(10) << "percent" << std::setw(14) << "cycles/call" << std::endl;
+
+    for (std::uint32_t i = 0; i < ProfilePhase::PROFILEPHASE_COUNT; i++) {
+        const double percent = totalCycles == 0 ? 0.0 : 100.0 * double(this->cycles[i]) / double(totalCycles);
+        const double cyclesPerCall = this->calls[i] == 0 ? 0.0 : double(this->cycles[i]) / double(this->calls[i]);
+
+        std::cout << std::left << std::setw(18) << ProfilePhaseNames[i] << std::right
+            << std::setw(14) << this->calls[i] << std::setw(18) << this->cycles[i]
+            << std::fixed << std::setprecision(2) << std::setw(10) << percent << std::setprecision(1) << std::setw(14) << cyclesPerCall << std::endl;
+    }
+}
+
+void CycleProfile::reset()
+{
+    this->cycles.fill(0);
+    this->calls.fill(0);
+}
+
+void MergeCycleProfile()
+{
+    if constexpr (enableCycleProfiler) {
+        std::lock_guard<std::mutex> lock(CycleProfileMutex);
+
+        SharedCycleProfile.merge(CycleProfilerState.profile);
+        CycleProfilerState.profile.reset();
+    }
+}
+
+CycleProfile GetCycleProfile()
+{
+    std::lock_guard<std::mutex> lock(CycleProfileMutex);
+
+    return SharedCycleProfile;
+}
+
+void ResetCycleProfile()
+{
+    std::lock_guard<std::mutex> lock(CycleProfileMutex);
+
+    SharedCycleProfile.reset();
+}
@@ -0,0 +1,118 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#ifdef _MSC_VER
+# include <intrin.h>
+#else
+# include <x86intrin.h>
+#endif
+
+//Builds made with CYCLE_PROFILER defined time the hot parts of the search; otherwise the scopes are empty and compile away
+#if defined(CYCLE_PROFILER)
+constexpr bool enableCycleProfiler = true;
+#else
+constexpr bool enableCycleProfiler = false;
+#endif
+
+enum ProfilePhase : std::uint32_t {
+    SEARCH,
+    MOVE_GENERATION,
+    MOVE_ORDERING,
+    STATIC_EXCHANGE_EVALUATION,
+    EVALUATION,
+    DO_MOVE,
+    HASHTABLE_PROBE,
+
+    PROFILEPHASE_COUNT,
+    NO_PROFILEPHASE = PROFILEPHASE_COUNT
+};
+
+struct CycleProfile
+{
+    std::array<std::uint64_t, ProfilePhase::PROFILEPHASE_COUNT> cycles = {};
+    std::array<std::uint64_t, ProfilePhase::PROFILEPHASE_COUNT> calls = {};
+
+    void merge(const CycleProfile& cycleProfile);
+    void print() const;
+    void reset();
+};
+
+//Each thread times into its own profile, so nothing is shared on the hot path
+struct CycleProfilerThreadState
+{
+    CycleProfile profile;
+
+    ProfilePhase currentPhase = ProfilePhase::NO_PROFILEPHASE;
+    std::uint64_t phaseStart = 0;
+};
+
+extern thread_local CycleProfilerThreadState CycleProfilerState;
+
+//Charges the cycles spent inside a scope to its phase.  A nested scope pauses the one around it, so each phase
+//only counts its own time.
+class ScopedCycleProfile
+{
+protected:
+    ProfilePhase parentPhase = ProfilePhase::NO_PROFILEPHASE;
+public:
+    constexpr ScopedCycleProfile(ProfilePhase phase)
+    {
+        if constexpr (enableCycleProfiler) {
+            if (!std::is_constant_evaluated()) {
+                CycleProfilerThreadState& state = CycleProfilerState;
+                const std::uint64_t now = __rdtsc();
+
+                if (state.currentPhase != ProfilePhase::NO_PROFILEPHASE) {
+                    state.profile.cycles[state.currentPhase] += now - state.phaseStart;
+                }
+
+                this->parentPhase = state.currentPhase;
+
+                state.currentPhase = phase;
+                state.phaseStart = now;
+                state.profile.calls[phase]++;
+            }
+        }
+    }
+
+    constexpr ~ScopedCycleProfile()
+    {
+        if constexpr (enableCycleProfiler) {
+            if (!std::is_constant_evaluated()) {
+                CycleProfilerThreadState& state = CycleProfilerState;
+                const std::uint64_t now = __rdtsc();
+
+                state.profile.cycles[state.currentPhase] += now - state.phaseStart;
+
+                state.currentPhase = this->parentPhase;
+                state.phaseStart = now;
+            }
+        }
+    }
+};
+
+//Adds this thread's profile to the shared one and starts it over, once a search completes
+void MergeCycleProfile();
+CycleProfile GetCycleProfile();
+void ResetCycleProfile();
@@ -18,22 +18,35 @@
 
 #pragma once
 
-#include <map>
+#include <array>
+
+#include <cstdint>
 
 #include "../types/color.h"
 #include "../types/hash.h"
 #include "../types/score.h"
 
+//Open addressed by the top bits of the material hash (the low bits of the piece hashes are patterned);
+//kept sparse so a miss almost always stops at the first slot
+constexpr std::uint32_t EndgameTableBits = 10;
+constexpr std::uint32_t EndgameTableSize = 1 << EndgameTableBits;
+constexpr Hash EndgameTableMask = EndgameTableSize - 1;
+
 template <class Board>
 class Endgame
 {
 public:
     using BoardType = Board;
     using EndgameFunctionType = bool (*) (const BoardType& board, Score& score);
-    using EndgameFunctionMapType = std::map<Hash, EndgameFunctionType>;
 
 protected:
-    EndgameFunctionMapType endgameFunctionMap;
+    struct EndgameEntry {
+        Hash materialHash;
+        EndgameFunctionType endgameFunction;
+    };
+
+    std::array<EndgameEntry, EndgameTableSize> endgameTable{};
+    std::uint32_t endgameCount = 0;
 
     static constexpr bool nullEndgameFunction(const BoardType& board, Score& score)
     {
@@ -46,20 +59,46 @@ public:
     constexpr bool add(const BoardType& board, const EndgameFunctionType& endgameFunction)
     {
         const Hash materialHash = board.materialHashValue;
-        Endgame::endgameFunctionMap[materialHash] = endgameFunction;
 
-        return true;
+        //Leave at least one empty slot so a probe always terminates
+        if (this->endgameCount >= EndgameTableSize - 1) {
+            return false;
+        }
+
+        for (Hash index = materialHash >> (64 - EndgameTableBits); ; index = (index + 1) & EndgameTableMask) {
+            EndgameEntry& endgameEntry = this->endgameTable[index];
+
+            if (endgameEntry.endgameFunction == nullptr) {
+                endgameEntry.materialHash = materialHash;
+                endgameEntry.endgameFunction = endgameFunction;
+
+                this->endgameCount++;
+
+                return true;
+            }
+
+            if (endgameEntry.materialHash == materialHash) {
+                endgameEntry.endgameFunction = endgameFunction;
+
+                return true;
+            }
+        }
     }
      
     constexpr bool probe(const BoardType& board, Score& score) const
     {
         const Hash materialHash = board.materialHashValue;
 
-        if (Endgame::endgameFunctionMap.count(materialHash) == 0) {
-            return false;
-        }
+        for (Hash index = materialHash >> (64 - EndgameTableBits); ; index = (index + 1) & EndgameTableMask) {
+            const EndgameEntry& endgameEntry = this->endgameTable[index];
 
-        const EndgameFunctionType& endgameFunction = Endgame::endgameFunctionMap.at(materialHash);
-        return endgameFunction(board, score);
+            if (endgameEntry.endgameFunction == nullptr) {
+                return false;
+            }
+
+            if (endgameEntry.materialHash == materialHash) {
+                return endgameEntry.endgameFunction(board, score);
+            }
+        }
     }
 };
@@ -0,0 +1,155 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//A read-only view of a whole file.  Every process mapping the same file shares its pages through the page cache.
+class MappedFile
+{
+protected:
+    const std::uint8_t* data = nullptr;
+    std::size_t size = 0;
+
+#ifdef _MSC_VER
+    HANDLE mapping = nullptr;
+#endif
+public:
+    MappedFile() = default;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile()
+    {
+        this->close();
+    }
+
+    const std::uint8_t* getData() const
+    {
+        return this->data;
+    }
+
+    std::size_t getSize() const
+    {
+        return this->size;
+    }
+
+    bool isOpen() const
+    {
+        return this->data != nullptr;
+    }
+
+    bool open(const std::string& fileName)
+    {
+        this->close();
+
+#ifdef _MSC_VER
+        const HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+
+        //The mapping keeps the file open by itself
+        this->mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+
+        if (this->mapping == nullptr) {
+            return false;
+        }
+
+        this->data = static_cast<const std::uint8_t*>(MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, 0));
+
+        if (this->data == nullptr) {
+            CloseHandle(this->mapping);
+            this->mapping = nullptr;
+
+            return false;
+        }
+
+        this->size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+        const int file = ::open(fileName.c_str(), O_RDONLY);
+
+        if (file < 0) {
+            return false;
+        }
+
+        struct stat fileStatus;
+
+        if (fstat(file, &fileStatus) != 0 || fileStatus.st_size == 0) {
+            ::close(file);
+            return false;
+        }
+
+        //The mapping keeps the file open by itself
+        void* mapping = mmap(nullptr, fileStatus.st_size, PROT_READ, MAP_SHARED, file, 0);
+        ::close(file);
+
+        if (mapping == MAP_FAILED) {
+            return false;
+        }
+
+        this->data = static_cast<const std::uint8_t*>(mapping);
+        this->size = static_cast<std::size_t>(fileStatus.st_size);
+#endif
+
+        return true;
+    }
+
+    void close()
+    {
+        if (this->data == nullptr) {
+            return;
+        }
+
+#ifdef _MSC_VER
+        UnmapViewOfFile(this->data);
+        CloseHandle(this->mapping);
+
+        this->mapping = nullptr;
+#else
+        munmap(const_cast<std::uint8_t*>(this->data), this->size);
+#endif
+
+        this->data = nullptr;
+        this->size = 0;
+    }
+};
@@ -0,0 +1,99 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "cpufeatures.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+using CpuidRegisters = std::array<std::uint32_t, 4>;
+
+static bool Cpuid(std::uint32_t leaf, std::uint32_t subleaf, CpuidRegisters& registers)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int result[4];
+    __cpuidex(result, leaf, subleaf);
+
+    for (std::size_t i = 0; i < registers.size(); i++) {
+        registers[i] = static_cast<std::uint32_t>(result[i]);
+    }
+
+    return true;
+#elif defined(__x86_64__) || defined(__i386__)
+    return __get_cpuid_count(leaf, subleaf, &registers[0], &registers[1], &registers[2], &registers[3]) != 0;
+#else
+    registers = {};
+
+    return false;
+#endif
+}
+
+static CpuFeatures DetectCpuFeatures()
+{
+    CpuFeatures features;
+    CpuidRegisters registers;
+
+    //1) Leaf 0 has the highest leaf and the vendor, spelled out over ebx, edx and ecx
+    if (!Cpuid(0, 0, registers)) {
+        return features;
+    }
+
+    const std::uint32_t maximumLeaf = registers[0];
+
+    char vendor[13] = {};
+    std::memcpy(vendor, &registers[1], 4);
+    std::memcpy(vendor + 4, &registers[3], 4);
+    std::memcpy(vendor + 8, &registers[2], 4);
+
+    //2) Leaf 1 has popcnt and the family, whose extended bits only count when the base family is 0xf
+    Cpuid(1, 0, registers);
+
+    features.popcnt = (registers[2] & (1u << 23)) != 0;
+
+    const std::uint32_t baseFamily = (registers[0] >> 8) & 0xf;
+    const std::uint32_t family = baseFamily == 0xf ? baseFamily + ((registers[0] >> 20) & 0xff) : baseFamily;
+
+    //3) Leaf 7 has bmi2
+    if (maximumLeaf >= 7) {
+        Cpuid(7, 0, registers);
+
+        features.bmi2 = (registers[1] & (1u << 8)) != 0;
+    }
+
+    //4) Zen 1 and 2 are family 0x17, and Hygon's Zen 1 derivative is 0x18
+    const bool isAmd = std::strcmp(vendor, "AuthenticAMD") == 0 || std::strcmp(vendor, "HygonGenuine") == 0;
+
+    features.fastPext = features.bmi2 && !(isAmd && family < 0x19);
+
+    return features;
+}
+
+const CpuFeatures& GetCpuFeatures()
+{
+    static const CpuFeatures cpuFeatures = DetectCpuFeatures();
+
+    return cpuFeatures;
+}
+
+bool UsePopCountInstruction = GetCpuFeatures().popcnt;
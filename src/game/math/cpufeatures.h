@@ -0,0 +1,77 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <bit>
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+struct CpuFeatures {
+    bool popcnt = false;
+    bool bmi2 = false;
+
+    //Zen 1 and 2 run pext in microcode, so multiply magics beat it there
+    bool fastPext = false;
+};
+
+const CpuFeatures& GetCpuFeatures();
+
+//Set at startup, so a build without -mpopcnt still counts bits with the instruction on hosts that have it
+extern bool UsePopCountInstruction;
+
+//The instructions are emitted inline whatever the target flags are, so only call these when GetCpuFeatures() says they exist
+inline std::uint32_t PopCountInstruction(std::uint64_t n)
+{
+#if defined(__POPCNT__)
+    return static_cast<std::uint32_t>(std::popcount(n));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<std::uint32_t>(__popcnt64(n));
+#elif defined(__x86_64__)
+    std::uint64_t result;
+    __asm__("popcntq %1, %0" : "=r"(result) : "rm"(n) : "cc");
+    return static_cast<std::uint32_t>(result);
+#else
+    return static_cast<std::uint32_t>(std::popcount(n));
+#endif
+}
+
+inline std::uint64_t PextInstruction(std::uint64_t bitboard, std::uint64_t mask)
+{
+#if defined(__BMI2__) || (defined(_MSC_VER) && defined(_M_X64))
+    return _pext_u64(bitboard, mask);
+#elif defined(__x86_64__)
+    std::uint64_t result;
+    __asm__("pextq %2, %1, %0" : "=r"(result) : "r"(bitboard), "rm"(mask));
+    return result;
+#else
+    std::uint64_t result = 0;
+
+    for (std::uint64_t bit = 1; mask != 0; mask &= mask - 1, bit <<= 1) {
+        result |= (bitboard & mask & (0 - mask)) != 0 ? bit : 0;
+    }
+
+    return result;
+#endif
+}
@@ -19,10 +19,21 @@
 #pragma once
 
 #include <bit>
+#include <type_traits>
+
 #include <cstdint>
 
+#include "cpufeatures.h"
+
 constexpr std::uint32_t PopCount(std::uint64_t n)
 {
+#if !defined(__POPCNT__) && !defined(_MSC_VER)
+    //Without -mpopcnt std::popcount is a library call, so use the instruction when the cpu has it
+    if (!std::is_constant_evaluated() && UsePopCountInstruction) {
+        return PopCountInstruction(n);
+    }
+#endif
+
     return std::popcount(n);
 }
 
@@ -0,0 +1,208 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include "../types/result.h"
+
+struct SprtSettings {
+    double elo0 = 0.5;
+    double elo1 = 2.5;
+
+    double alpha = 0.05;
+    double beta = 0.05;
+};
+
+enum SprtResult {
+    SPRT_CONTINUE, SPRT_ACCEPT_H0, SPRT_ACCEPT_H1
+};
+
+//Wins, losses and draws of the first player, tested the way cutechess does: the draw rate is measured with the BayesElo model and
+//the log likelihood ratio compares elo0 against elo1 at that draw rate
+class Sprt
+{
+protected:
+    SprtSettings settings;
+
+    std::uint64_t wins = 0;
+    std::uint64_t losses = 0;
+    std::uint64_t draws = 0;
+
+    //Probabilities of a win and a loss at a BayesElo difference and draw elo
+    static void calculateProbabilities(double bayesElo, double drawElo, double& winProbability, double& lossProbability)
+    {
+        winProbability = 1.0 / (1.0 + std::pow(10.0, (drawElo - bayesElo) / 400.0));
+        lossProbability = 1.0 / (1.0 + std::pow(10.0, (drawElo + bayesElo) / 400.0));
+    }
+
+    //Elo difference of a score between 0 and 1
+    static double calculateElo(double score)
+    {
+        return -400.0 * std::log10(1.0 / score - 1.0);
+    }
+public:
+    Sprt(const SprtSettings& settings) : settings(settings) {}
+    ~Sprt() = default;
+
+    void addResult(TwoPlayerGameResult result)
+    {
+        switch (result) {
+        case TwoPlayerGameResult::WIN:
+            this->wins++;
+            break;
+        case TwoPlayerGameResult::LOSS:
+            this->losses++;
+            break;
+        case TwoPlayerGameResult::DRAW:
+            this->draws++;
+            break;
+        default:
+            break;
+        }
+    }
+
+    std::uint64_t getGameCount() const
+    {
+        return this->wins + this->losses + this->draws;
+    }
+
+    std::uint64_t getWins() const
+    {
+        return this->wins;
+    }
+
+    std::uint64_t getLosses() const
+    {
+        return this->losses;
+    }
+
+    std::uint64_t getDraws() const
+    {
+        return this->draws;
+    }
+
+    double getScore() const
+    {
+        const std::uint64_t gameCount = this->getGameCount();
+
+        return gameCount > 0 ? (this->wins + this->draws / 2.0) / gameCount : 0.5;
+    }
+
+    double getElo() const
+    {
+        const double score = this->getScore();
+
+        if (score <= 0.0 || score >= 1.0) {
+            return score <= 0.0 ? -INFINITY : INFINITY;
+        }
+
+        return calculateElo(score);
+    }
+
+    //Half the width of the 95% confidence interval
+    double getEloMargin() const
+    {
+        const std::uint64_t gameCount = this->getGameCount();
+
+        if (gameCount == 0) {
+            return 0.0;
+        }
+
+        const double score = this->getScore();
+
+        const double winDeviation = this->wins * std::pow(1.0 - score, 2.0);
+        const double lossDeviation = this->losses * std::pow(0.0 - score, 2.0);
+        const double drawDeviation = this->draws * std::pow(0.5 - score, 2.0);
+
+        const double deviation = std::sqrt((winDeviation + lossDeviation + drawDeviation) / gameCount) / std::sqrt(double(gameCount));
+
+        const double lowScore = score - 1.959964 * deviation;
+        const double highScore = score + 1.959964 * deviation;
+
+        if (lowScore <= 0.0 || highScore >= 1.0) {
+            return INFINITY;
+        }
+
+        return (calculateElo(highScore) - calculateElo(lowScore)) / 2.0;
+    }
+
+    //Likelihood of superiority, the chance the first player is the stronger one
+    double getLos() const
+    {
+        if (this->wins + this->losses == 0) {
+            return 0.5;
+        }
+
+        return 0.5 * (1.0 + std::erf((double(this->wins) - double(this->losses)) / std::sqrt(2.0 * (this->wins + this->losses))));
+    }
+
+    double getLlr() const
+    {
+        if (this->wins == 0 || this->losses == 0 || this->draws == 0) {
+            return 0.0;
+        }
+
+        const double gameCount = double(this->getGameCount());
+
+        const double winRate = this->wins / gameCount;
+        const double lossRate = this->losses / gameCount;
+
+        //1) Measure the draw elo, which scales logistic elo into BayesElo
+        const double drawElo = 200.0 * std::log10((1.0 - lossRate) / lossRate * (1.0 - winRate) / winRate);
+
+        const double x = std::pow(10.0, -drawElo / 400.0);
+        const double scale = 4.0 * x / ((1.0 + x) * (1.0 + x));
+
+        //2) Then compare how likely the results are under each hypothesis
+        double win0, loss0, win1, loss1;
+
+        calculateProbabilities(this->settings.elo0 / scale, drawElo, win0, loss0);
+        calculateProbabilities(this->settings.elo1 / scale, drawElo, win1, loss1);
+
+        return this->wins * std::log(win1 / win0)
+            + this->losses * std::log(loss1 / loss0)
+            + this->draws * std::log((1.0 - win1 - loss1) / (1.0 - win0 - loss0));
+    }
+
+    double getLowerBound() const
+    {
+        return std::log(this->settings.beta / (1.0 - this->settings.alpha));
+    }
+
+    double getUpperBound() const
+    {
+        return std::log((1.0 - this->settings.beta) / this->settings.alpha);
+    }
+
+    SprtResult getResult() const
+    {
+        const double llr = this->getLlr();
+
+        if (llr >= this->getUpperBound()) {
+            return SprtResult::SPRT_ACCEPT_H1;
+        }
+        else if (llr <= this->getLowerBound()) {
+            return SprtResult::SPRT_ACCEPT_H0;
+        }
+
+        return SprtResult::SPRT_CONTINUE;
+    }
+};
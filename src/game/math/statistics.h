@@ -18,8 +18,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <vector>
 
+#include <cmath>
 #include <cstdint>
 
 template <typename T>
@@ -48,6 +50,17 @@ public:
     constexpr void clear()
     {
         this->data.clear();
+
+        this->sum = 0;
+    }
+
+    constexpr value_type maximum() const
+    {
+        if (this->data.size() == 0) {
+            return 0;
+        }
+
+        return *std::max_element(this->data.begin(), this->data.end());
     }
 
     constexpr const value_type& operator[](const size_type _Pos) const
@@ -62,6 +75,11 @@ public:
         this->sum += sample;
     }
 
+    constexpr size_type size() const
+    {
+        return this->data.size();
+    }
+
     constexpr float stddev() const
     {
         if (this->data.size() == 0) {
@@ -16,6 +16,7 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <cassert>
 
 #include "hashtable.h"
@@ -36,6 +37,24 @@ Hashtable::~Hashtable()
     }
 }
 
+std::uint32_t Hashtable::getHashfull() const
+{
+    const std::uint32_t sampleCount = std::min(this->hashEntryCount, std::uint32_t(1000));
+
+    std::uint32_t usedCount = 0;
+
+    for (std::uint32_t i = 0; i < sampleCount; i++) {
+        const HashtableEntry& hashtableEntry = this->hashEntryList[i];
+
+        if (hashtableEntry.search.hashValue != EmptyHash
+            && hashtableEntry.search.age == this->currentAge) {
+            usedCount++;
+        }
+    }
+
+    return sampleCount == 0 ? 0 : usedCount * 1000 / sampleCount;
+}
+
 void Hashtable::incrementAge()
 {
     this->currentAge++;
@@ -172,6 +172,9 @@ public:
     Hashtable();
     ~Hashtable();
 
+    //Permille of a sample of entries written during this search, as engines report it
+    std::uint32_t getHashfull() const;
+
     void incrementAge();
 
     void initialize(std::uint32_t entryCount);
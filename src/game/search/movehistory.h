@@ -18,10 +18,21 @@
 
 #pragma once
 
-#include <vector>
+#include <algorithm>
+#include <array>
+
+#include <cstdint>
 
 #include "../types/hash.h"
 
+//Only the positions since the last irreversible move can repeat, so once the history fills up
+//the oldest half is dropped rather than growing it
+constexpr std::uint32_t MoveHistorySize = 1024;
+
+//A small count of history positions by hash bits, to skip the scan when a position can't be a repetition
+constexpr std::uint32_t MoveHistoryFilterSize = 4096;
+constexpr Hash MoveHistoryFilterMask = MoveHistoryFilterSize - 1;
+
 template <class Board, class Move>
 class MoveHistory
 {
@@ -33,63 +44,138 @@ protected:
     struct MoveHistoryStruct {
         Hash hashValue;
         MoveType move;
-        bool irreversible;
+        std::uint32_t reversiblePlies;
     };
 
 public:
     using MoveHistoryStructType = MoveHistoryStruct;
 
 protected:
-    std::vector<MoveHistoryStructType> moveHistoryList;
-    using size_type = typename std::vector<MoveHistoryStructType>::size_type;
+    std::array<MoveHistoryStructType, MoveHistorySize> moveHistoryList;
+    std::uint32_t moveHistoryCount = 0;
+
+    std::array<std::uint8_t, MoveHistoryFilterSize> moveHistoryFilter{};
+
+    constexpr void dropOldestHalf()
+    {
+        constexpr std::uint32_t keep = MoveHistorySize / 2;
+        const std::uint32_t first = this->moveHistoryCount - keep;
+
+        std::copy(this->moveHistoryList.begin() + first, this->moveHistoryList.begin() + this->moveHistoryCount, this->moveHistoryList.begin());
+        this->moveHistoryCount = keep;
+
+        this->moveHistoryFilter.fill(0);
+
+        for (std::uint32_t i = 0; i < this->moveHistoryCount; i++) {
+            this->moveHistoryFilter[this->moveHistoryList[i].hashValue & MoveHistoryFilterMask]++;
+        }
+    }
 
 public:
 
     constexpr MoveHistory() = default;
     constexpr ~MoveHistory() = default;
 
+    //hashValue is the position on top of the history; the result counts it along with every earlier occurrence
     constexpr std::uint32_t checkForDuplicateHash(Hash hashValue) const
     {
-        std::uint32_t result = 0;
+        //1) Nothing else in the history shares these hash bits
+        if (this->moveHistoryFilter[hashValue & MoveHistoryFilterMask] <= 1
+            || this->moveHistoryCount == 0) {
+            return 1;
+        }
+
+        //2) Only the same side to move, back to the last irreversible move, can match
+        const std::uint32_t top = this->moveHistoryCount - 1;
+        const std::uint32_t maxDistance = this->getReversiblePlies();
 
-        for (auto it = this->moveHistoryList.rbegin(); it != this->moveHistoryList.rend(); ++it) {
-            const MoveHistoryStructType& moveHistoryStruct = (*it);
+        std::uint32_t result = 1;
 
-            if (moveHistoryStruct.hashValue == hashValue) {
+        for (std::uint32_t distance = 4; distance <= maxDistance; distance += 2) {
+            if (this->moveHistoryList[top - distance].hashValue == hashValue) {
                 result++;
             }
+        }
+
+        return result;
+    }
+
+    //Hash of the position distance plies before the one on top
+    constexpr Hash getHashValue(std::uint32_t distance) const
+    {
+        return this->moveHistoryList[this->moveHistoryCount - 1 - distance].hashValue;
+    }
+
+    //How far back from the top a repetition can reach
+    constexpr std::uint32_t getReversiblePlies() const
+    {
+        if (this->moveHistoryCount == 0) {
+            return 0;
+        }
+
+        const std::uint32_t top = this->moveHistoryCount - 1;
+
+        return std::min(this->moveHistoryList[top].reversiblePlies, top);
+    }
+
+    //Whether the position distance plies back had itself already occurred before
+    constexpr bool isRepeatedAt(std::uint32_t distance) const
+    {
+        const std::uint32_t index = this->moveHistoryCount - 1 - distance;
+        const MoveHistoryStructType& moveHistoryStruct = this->moveHistoryList[index];
+
+        const std::uint32_t maxDistance = std::min(moveHistoryStruct.reversiblePlies, index);
 
-            if (moveHistoryStruct.irreversible) {
-                break;
+        for (std::uint32_t i = 4; i <= maxDistance; i += 2) {
+            if (this->moveHistoryList[index - i].hashValue == moveHistoryStruct.hashValue) {
+                return true;
             }
         }
 
-        return result;
+        return false;
     }
 
     constexpr void clear()
     {
-        this->moveHistoryList.clear();
+        this->moveHistoryCount = 0;
+        this->moveHistoryFilter.fill(0);
     }
 
     constexpr void pop_back()
     {
-        this->moveHistoryList.pop_back();
+        this->moveHistoryCount--;
+
+        this->moveHistoryFilter[this->moveHistoryList[this->moveHistoryCount].hashValue & MoveHistoryFilterMask]--;
     }
 
     constexpr void push_back(const BoardType& board, const MoveType& move, bool irreversible = false)
     {
-        MoveHistoryStructType moveHistoryStruct{
-            board.hashValue,
-            move,
-            irreversible
-        };
+        if (this->moveHistoryCount == MoveHistorySize) {
+            this->dropOldestHalf();
+        }
+
+        //Plies since the last irreversible move; a null move also counts as one
+        std::uint32_t reversiblePlies = board.fiftyMoveCount;
+
+        if (irreversible) {
+            reversiblePlies = 0;
+        }
+        else if (this->moveHistoryCount > 0) {
+            reversiblePlies = std::min(reversiblePlies, this->moveHistoryList[this->moveHistoryCount - 1].reversiblePlies + 1);
+        }
+
+        MoveHistoryStructType& moveHistoryStruct = this->moveHistoryList[this->moveHistoryCount];
+
+        moveHistoryStruct.hashValue = board.hashValue;
+        moveHistoryStruct.move = move;
+        moveHistoryStruct.reversiblePlies = reversiblePlies;
 
-        this->moveHistoryList.push_back(moveHistoryStruct);
+        this->moveHistoryFilter[board.hashValue & MoveHistoryFilterMask]++;
+        this->moveHistoryCount++;
     }
 
-    constexpr void reserve(const size_type _Newcapacity)
+    constexpr std::uint32_t size() const
     {
-        this->moveHistoryList.reserve(_Newcapacity);
+        return this->moveHistoryCount;
     }
 };
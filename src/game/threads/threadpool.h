@@ -0,0 +1,148 @@
+/*
+    Jing Wei, the rebirth of the chess engine I started in 2010
+    Copyright(C) 2019-2024 Chris Florin
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+protected:
+    std::vector<std::thread> threads;
+    std::deque<std::function<void()>> tasks;
+
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable tasksFinished;
+
+    std::uint32_t activeTasks = 0;
+    bool stopping = false;
+
+    void workerLoop()
+    {
+        while (true) {
+            std::function<void()> task;
+
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                this->taskAvailable.wait(lock, [this]() { return this->stopping || !this->tasks.empty(); });
+
+                if (this->tasks.empty()) {
+                    return;
+                }
+
+                task = std::move(this->tasks.front());
+                this->tasks.pop_front();
+
+                this->activeTasks++;
+            }
+
+            task();
+
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                this->activeTasks--;
+
+                if (this->activeTasks == 0 && this->tasks.empty()) {
+                    this->tasksFinished.notify_all();
+                }
+            }
+        }
+    }
+public:
+    //A thread count of zero uses one thread per hardware thread
+    explicit ThreadPool(std::uint32_t threadCount = 0)
+    {
+        if (threadCount == 0) {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        for (std::uint32_t i = 0; i < threadCount; i++) {
+            this->threads.emplace_back(&ThreadPool::workerLoop, this);
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->stopping = true;
+        }
+
+        this->taskAvailable.notify_all();
+
+        for (std::thread& thread : this->threads) {
+            thread.join();
+        }
+    }
+
+    std::uint32_t size() const
+    {
+        return static_cast<std::uint32_t>(this->threads.size());
+    }
+
+    void submit(std::function<void()> task)
+    {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->tasks.push_back(std::move(task));
+        }
+
+        this->taskAvailable.notify_one();
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->tasksFinished.wait(lock, [this]() { return this->activeTasks == 0 && this->tasks.empty(); });
+    }
+
+    //Splits [0, count) into chunks handed out to every thread, calling function(first, last) for each, and waits for all of them
+    template <typename Function>
+    void parallelFor(std::uint64_t count, std::uint64_t chunkSize, Function function)
+    {
+        std::atomic<std::uint64_t> nextChunk = 0;
+
+        for (std::uint32_t i = 0; i < this->size(); i++) {
+            this->submit([&]() {
+                while (true) {
+                    const std::uint64_t first = nextChunk.fetch_add(chunkSize);
+
+                    if (first >= count) {
+                        break;
+                    }
+
+                    function(first, std::min(first + chunkSize, count));
+                }
+            });
+        }
+
+        this->wait();
+    }
+};
@@ -192,7 +192,7 @@ union Evaluation {
         return result;
     }
 
-    constexpr Evaluation operator - ()
+    constexpr Evaluation operator - () const
     {
         if (std::is_constant_evaluated()) {
             return Evaluation{ -this->mg, -this->eg };
@@ -209,7 +209,7 @@ union Evaluation {
         }
     }
 
-    constexpr Evaluation operator * (const std::int32_t i)
+    constexpr Evaluation operator * (const std::int32_t i) const
     {
         Evaluation result;
 
@@ -231,7 +231,7 @@ union Evaluation {
         return result;
     }
 
-    constexpr Evaluation operator / (const std::int32_t i)
+    constexpr Evaluation operator / (const std::int32_t i) const
     {
         Evaluation result;
 
@@ -253,7 +253,7 @@ union Evaluation {
         return result;
     }
 
-    constexpr bool operator == (Evaluation e2)
+    constexpr bool operator == (Evaluation e2) const
     {
         if (std::is_constant_evaluated()) {
             return (this->mg == e2.mg) && (this->eg == e2.eg);